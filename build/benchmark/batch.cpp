@@ -0,0 +1,96 @@
+//-----------------------------------------------------------------------------------------
+// Batch error collection benchmark
+//
+// N threads process an interleaved range of elements where one in FailEvery fails with a
+// chained error. The failures are collected into a mutex protected vector (what a plain
+// parallel loop does) or into an xerr::batch. We report the elements per second for 1..N threads.
+//
+// usage: xerr_bench_batch [max_threads] [elements] [fail_every]
+//-----------------------------------------------------------------------------------------
+#include "xerr_batch.h"
+#include "bench_common.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    enum class bench_error : std::uint8_t
+    { OK
+    , FAILURE
+    , INVALID
+    };
+
+    //------------------------------------------------------------------------------------
+
+    XERR_BENCH_NOINLINE xerr Process(std::size_t Index, std::size_t FailEvery) noexcept
+    {
+        if (Index % FailEvery) return {};
+        auto Err = xerr::create<bench_error::INVALID, "Bad record">();
+        return xerr::create_f<bench_error, "Process failed">(Err);
+    }
+
+    //------------------------------------------------------------------------------------
+
+    template< typename T_BODY >
+    double RunThreads(int nThreads, std::size_t Elements, T_BODY&& Body) noexcept
+    {
+        std::vector<std::thread> Threads;
+
+        const auto Start = std::chrono::steady_clock::now();
+        for (int t = 0; t < nThreads; ++t)
+        {
+            Threads.emplace_back([&, t]
+            {
+                for (std::size_t i = t; i < Elements; i += nThreads) Body(i);
+            });
+        }
+        for (auto& T : Threads) T.join();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+    }
+}
+
+//-----------------------------------------------------------------------------------------
+
+int main(int argc, const char* argv[])
+{
+    const int         MaxThreads = argc > 1 ? std::atoi(argv[1]) : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    const std::size_t Elements   = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 4000000;
+    const std::size_t FailEvery  = argc > 3 ? std::max<std::size_t>(1, std::strtoull(argv[3], nullptr, 10)) : 10;
+
+    std::printf("batch error collection (%zu elements, one in %zu fails)\n", Elements, FailEvery);
+    std::printf("%8s %20s %20s\n", "threads", "mutex vector el/s", "xerr::batch el/s");
+
+    for (int nThreads = 1; nThreads <= MaxThreads; nThreads = nThreads < MaxThreads && nThreads * 2 > MaxThreads ? MaxThreads : nThreads * 2)
+    {
+        std::mutex                                      Lock;
+        std::vector<std::pair<std::size_t, xerr>>       Failures;
+        const double MutexSeconds = RunThreads(nThreads, Elements, [&](std::size_t i)
+        {
+            if (auto Err = Process(i, FailEvery); Err)
+            {
+                std::lock_guard Guard{ Lock };
+                Failures.emplace_back(i, Err);
+                Err.clear();
+            }
+        });
+
+        xerr::batch Batch{ Elements };
+        const double BatchSeconds = RunThreads(nThreads, Elements, [&](std::size_t i)
+        {
+            Batch.Invoke(i, [&] { return Process(i, FailEvery); });
+        });
+
+        if (Failures.size() != Batch.getFailedCount()) std::printf("warning: failure count mismatch (%zu vs %zu)\n", Failures.size(), Batch.getFailedCount());
+
+        std::printf("%8d %20.0f %20.0f\n", nThreads, static_cast<double>(Elements) / MutexSeconds, static_cast<double>(Elements) / BatchSeconds);
+        if (nThreads == MaxThreads) break;
+    }
+
+    return 0;
+}
@@ -0,0 +1,104 @@
+#ifndef XERR_BENCH_COMMON_H
+#define XERR_BENCH_COMMON_H
+#pragma once
+
+//-----------------------------------------------------------------------------------------
+// Small helpers shared by the xerr benchmarks. Nothing fancy: a monotonic clock, a cycle
+// counter when the CPU has one, a way to stop the optimizer from deleting the work and
+// a percentile report for latency samples.
+//-----------------------------------------------------------------------------------------
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+    #define XERR_BENCH_NOINLINE __declspec(noinline)
+#else
+    #if defined(__x86_64__) || defined(__i386__)
+        #include <x86intrin.h>
+    #endif
+    #define XERR_BENCH_NOINLINE __attribute__((noinline))
+#endif
+
+namespace xerr_bench
+{
+    //------------------------------------------------------------------------------------
+    // Keeps a value alive as far as the optimizer is concerned
+    template< typename T >
+    inline void DoNotOptimize(const T& Value) noexcept
+    {
+#if defined(_MSC_VER)
+        static volatile const void* s_pSink;
+        s_pSink = &Value;
+#else
+        asm volatile("" : : "r,m"(Value) : "memory");
+#endif
+    }
+
+    //------------------------------------------------------------------------------------
+    // Time stamp counter when available (reference cycles), otherwise nanoseconds
+    inline std::uint64_t Ticks(void) noexcept
+    {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        return __rdtsc();
+#elif defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+    }
+
+    //------------------------------------------------------------------------------------
+
+    struct result
+    {
+        double m_NsPerOp;
+        double m_TicksPerOp;
+    };
+
+    //------------------------------------------------------------------------------------
+    // Runs Function Iterations times (after a short warm up) and returns the cost per call
+    template< typename T_FUNCTION >
+    inline result Measure(std::size_t Iterations, T_FUNCTION&& Function) noexcept
+    {
+        for (std::size_t i = 0; i < Iterations / 16 + 1; ++i) Function();
+
+        const auto          Start       = std::chrono::steady_clock::now();
+        const std::uint64_t StartTicks  = Ticks();
+        for (std::size_t i = 0; i < Iterations; ++i) Function();
+        const std::uint64_t EndTicks    = Ticks();
+        const auto          End         = std::chrono::steady_clock::now();
+
+        return { std::chrono::duration<double, std::nano>(End - Start).count() / static_cast<double>(Iterations)
+               , static_cast<double>(EndTicks - StartTicks) / static_cast<double>(Iterations) };
+    }
+
+    //------------------------------------------------------------------------------------
+
+    inline void PrintHeader(const char* pTitle) noexcept
+    {
+        std::printf("\n%s\n%-48s %12s %12s\n", pTitle, "benchmark", "ns/op", "ticks/op");
+    }
+
+    //------------------------------------------------------------------------------------
+
+    inline void PrintResult(const char* pName, const result& Result) noexcept
+    {
+        std::printf("%-48s %12.2f %12.2f\n", pName, Result.m_NsPerOp, Result.m_TicksPerOp);
+    }
+
+    //------------------------------------------------------------------------------------
+    // Sorts the samples in place and returns the given percentile (0..100)
+    inline std::uint64_t Percentile(std::vector<std::uint64_t>& Samples, double P) noexcept
+    {
+        if (Samples.empty()) return 0;
+        const auto i = static_cast<std::size_t>(P / 100.0 * static_cast<double>(Samples.size() - 1));
+        std::nth_element(Samples.begin(), Samples.begin() + static_cast<std::ptrdiff_t>(i), Samples.end());
+        return Samples[i];
+    }
+}
+
+#endif
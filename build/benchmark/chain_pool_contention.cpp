@@ -0,0 +1,144 @@
+//-----------------------------------------------------------------------------------------
+// chain_pool contention benchmark
+//
+// Every thread runs the common chain/unchain cycle: a fresh error (which releases the
+// previous chain) followed by two chained errors. We report the aggregated throughput
+// for 1..N threads so the scaling of the pool can be compared across configurations,
+// plus the latency percentiles of a single chain/unchain cycle (in ticks, see bench_common.h).
+//
+// usage: xerr_bench_chain_pool [max_threads] [iterations_per_thread]
+//-----------------------------------------------------------------------------------------
+#include "xerr.h"
+#include "bench_common.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    enum class bench_error : std::uint8_t
+    { OK
+    , FAILURE
+    , IO_ERROR
+    , INVALID
+    };
+
+    //------------------------------------------------------------------------------------
+
+    XERR_BENCH_NOINLINE xerr LowLevel(void) noexcept
+    {
+        return xerr::create<bench_error::IO_ERROR, "Device not ready|Retry later">();
+    }
+
+    //------------------------------------------------------------------------------------
+
+    XERR_BENCH_NOINLINE xerr MidLevel(void) noexcept
+    {
+        if (auto Err = LowLevel(); Err) return xerr::create<bench_error::INVALID, "Read failed">(Err);
+        return {};
+    }
+
+    //------------------------------------------------------------------------------------
+
+    XERR_BENCH_NOINLINE xerr HighLevel(void) noexcept
+    {
+        if (auto Err = MidLevel(); Err) return xerr::create_f<bench_error, "Request failed">(Err);
+        return {};
+    }
+
+    //------------------------------------------------------------------------------------
+
+    struct run_result
+    {
+        double          m_Seconds;
+        std::uint64_t   m_P50;
+        std::uint64_t   m_P90;
+        std::uint64_t   m_P99;
+        std::uint64_t   m_P999;
+        std::uint64_t   m_Max;
+    };
+
+    //------------------------------------------------------------------------------------
+
+    run_result RunThreads(int nThreads, std::size_t Iterations) noexcept
+    {
+        std::atomic<int>                            Ready{ 0 };
+        std::atomic<bool>                           Go{ false };
+        std::vector<std::thread>                    Threads;
+        std::vector<std::size_t>                    Sink(nThreads);
+        std::vector<std::vector<std::uint64_t>>     Latency(nThreads);
+
+        for (int t = 0; t < nThreads; ++t)
+        {
+            Latency[t].reserve(Iterations);
+            Threads.emplace_back([&, t]
+            {
+                auto& Samples = Latency[t];
+
+                Ready.fetch_add(1);
+                while (!Go.load(std::memory_order_acquire)) std::this_thread::yield();
+
+                std::size_t Count = 0;
+                for (std::size_t i = 0; i < Iterations; ++i)
+                {
+                    const auto Start = xerr_bench::Ticks();
+                    if (auto Err = HighLevel(); Err && Err.hasChain()) ++Count;
+                    Samples.push_back(xerr_bench::Ticks() - Start);
+                }
+
+                // Release the last chain before the thread goes away
+                xerr::create_f<bench_error, "Done">();
+                Sink[t] = Count;
+            });
+        }
+
+        while (Ready.load() != nThreads) std::this_thread::yield();
+
+        const auto Start = std::chrono::steady_clock::now();
+        Go.store(true, std::memory_order_release);
+        for (auto& T : Threads) T.join();
+        const auto End = std::chrono::steady_clock::now();
+
+        for (auto Count : Sink) if (Count != Iterations) std::printf("warning: lost chains (%zu of %zu)\n", Count, Iterations);
+
+        std::vector<std::uint64_t> All;
+        All.reserve(Iterations * nThreads);
+        for (auto& Samples : Latency) All.insert(All.end(), Samples.begin(), Samples.end());
+
+        run_result Result;
+        Result.m_Seconds = std::chrono::duration<double>(End - Start).count();
+        Result.m_P50     = xerr_bench::Percentile(All, 50);
+        Result.m_P90     = xerr_bench::Percentile(All, 90);
+        Result.m_P99     = xerr_bench::Percentile(All, 99);
+        Result.m_P999    = xerr_bench::Percentile(All, 99.9);
+        Result.m_Max     = xerr_bench::Percentile(All, 100);
+        return Result;
+    }
+}
+
+//-----------------------------------------------------------------------------------------
+
+int main(int argc, const char* argv[])
+{
+    const int         MaxThreads = argc > 1 ? std::atoi(argv[1]) : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    const std::size_t Iterations = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1000000;
+
+    std::printf("chain_pool contention (magazine size %d, %zu iterations per thread)\n", xerr_details::chain_pool::magazine_size_v, Iterations);
+    std::printf("%8s %12s %16s %14s %8s %8s %8s %8s %10s\n", "threads", "seconds", "chains/s", "ns/chain/thread", "p50", "p90", "p99", "p99.9", "max");
+
+    for (int nThreads = 1; nThreads <= MaxThreads; nThreads = nThreads < MaxThreads && nThreads * 2 > MaxThreads ? MaxThreads : nThreads * 2)
+    {
+        const auto   R     = RunThreads(nThreads, Iterations);
+        const double Total = static_cast<double>(Iterations) * nThreads;
+        std::printf("%8d %12.4f %16.0f %14.2f %8llu %8llu %8llu %8llu %10llu\n", nThreads, R.m_Seconds, Total / R.m_Seconds, R.m_Seconds * 1e9 / static_cast<double>(Iterations)
+                   , static_cast<unsigned long long>(R.m_P50), static_cast<unsigned long long>(R.m_P90), static_cast<unsigned long long>(R.m_P99)
+                   , static_cast<unsigned long long>(R.m_P999), static_cast<unsigned long long>(R.m_Max));
+        if (nThreads == MaxThreads) break;
+    }
+
+    return 0;
+}
@@ -0,0 +1,44 @@
+//-----------------------------------------------------------------------------------------
+// Codegen check: the xerr happy path must compile to the same instructions as returning
+// and testing a raw pointer. codegen_check.cmake compiles this file to assembly and
+// compares each xerr_* function with its ptr_* twin.
+//-----------------------------------------------------------------------------------------
+#include "xerr.h"
+
+enum class codegen_error : std::uint8_t
+{ OK
+, FAILURE
+};
+
+using fn_xerr = xerr        (void);
+using fn_ptr  = const char* (void);
+
+// return {}
+xerr        xerr_return_ok  (void)          noexcept asm("xerr_return_ok");
+const char* ptr_return_ok   (void)          noexcept asm("ptr_return_ok");
+
+// if (auto Err = f(); Err) return 1; (operator bool)
+int         xerr_check      (fn_xerr* f)    noexcept asm("xerr_check");
+int         ptr_check       (fn_ptr*  f)    noexcept asm("ptr_check");
+
+// if (auto Err = f(); Err) return Err; return {}; (propagation)
+xerr        xerr_propagate  (fn_xerr* f)    noexcept asm("xerr_propagate");
+const char* ptr_propagate   (fn_ptr*  f)    noexcept asm("ptr_propagate");
+
+// return Value; for a packed xerr::result (it must stay a plain register return)
+xerr::result<int*>  xerr_result_ok  (int* p)    noexcept asm("xerr_result_ok");
+int*                ptr_result_ok   (int* p)    noexcept asm("ptr_result_ok");
+
+//-----------------------------------------------------------------------------------------
+
+xerr        xerr_return_ok  (void)          noexcept { return {}; }
+const char* ptr_return_ok   (void)          noexcept { return nullptr; }
+
+int         xerr_check      (fn_xerr* f)    noexcept { if (auto Err = f(); Err) return 1; return 0; }
+int         ptr_check       (fn_ptr*  f)    noexcept { if (auto p = f(); p) return 1; return 0; }
+
+xerr        xerr_propagate  (fn_xerr* f)    noexcept { if (auto Err = f(); Err) return Err; return {}; }
+const char* ptr_propagate   (fn_ptr*  f)    noexcept { if (auto p = f(); p) return p; return nullptr; }
+
+xerr::result<int*>  xerr_result_ok  (int* p)    noexcept { return p; }
+int*                ptr_result_ok   (int* p)    noexcept { return p; }
@@ -0,0 +1,63 @@
+#
+# Compiles codegen.cpp to assembly and verifies that every xerr_<name> function has the
+# same instructions as ptr_<name>.
+#
+# cmake -DCOMPILER=<c++> -DSOURCE=<codegen.cpp> -DINCLUDE=<xerr source dir> -DOUTPUT=<file.s> -P codegen_check.cmake
+#
+execute_process(
+  COMMAND ${COMPILER} -std=c++20 -O2 -S -fno-asynchronous-unwind-tables -I${INCLUDE} -o ${OUTPUT} ${SOURCE}
+  RESULT_VARIABLE COMPILE_RESULT
+  ERROR_VARIABLE  COMPILE_ERROR)
+
+if(NOT COMPILE_RESULT EQUAL 0)
+  message(FATAL_ERROR "codegen check: failed to compile ${SOURCE}\n${COMPILE_ERROR}")
+endif()
+
+file(STRINGS ${OUTPUT} ASM_LINES)
+
+# Returns the normalized instructions of a function (directives, comments and local
+# label names are removed so that two identical bodies compare equal)
+function(get_function_body NAME OUT)
+  set(BODY "")
+  set(INSIDE FALSE)
+  foreach(LINE IN LISTS ASM_LINES)
+    if(LINE MATCHES "^${NAME}:")
+      set(INSIDE TRUE)
+      continue()
+    endif()
+    if(INSIDE)
+      if(LINE MATCHES "^[A-Za-z_][A-Za-z0-9_]*:" OR LINE MATCHES "^[ \t]*\\.size" OR LINE MATCHES "^\\.Lfunc_end" OR LINE MATCHES "^[ \t]*\\.cfi_endproc")
+        break()
+      endif()
+      string(REGEX REPLACE "[#;].*$" "" LINE "${LINE}")
+      string(REGEX REPLACE "\\.L[A-Za-z0-9_]+" ".L" LINE "${LINE}")
+      string(STRIP "${LINE}" LINE)
+      if(LINE STREQUAL "" OR LINE MATCHES "^\\.[a-z_]+([ \t]|$)" OR LINE MATCHES "^\\.L:$")
+        continue()
+      endif()
+      list(APPEND BODY "${LINE}")
+    endif()
+  endforeach()
+  set(${OUT} "${BODY}" PARENT_SCOPE)
+endfunction()
+
+set(FAILED FALSE)
+foreach(NAME return_ok check propagate result_ok)
+  get_function_body(xerr_${NAME} XERR_BODY)
+  get_function_body(ptr_${NAME}  PTR_BODY)
+
+  if(XERR_BODY STREQUAL "")
+    message(FATAL_ERROR "codegen check: xerr_${NAME} not found in ${OUTPUT}")
+  endif()
+
+  if(XERR_BODY STREQUAL PTR_BODY)
+    message(STATUS "codegen check: ${NAME} OK (${XERR_BODY})")
+  else()
+    message(STATUS "codegen check: ${NAME} MISMATCH\n  xerr: ${XERR_BODY}\n  ptr:  ${PTR_BODY}")
+    set(FAILED TRUE)
+  endif()
+endforeach()
+
+if(FAILED)
+  message(FATAL_ERROR "codegen check: the xerr happy path differs from a raw pointer")
+endif()
@@ -0,0 +1,229 @@
+//-----------------------------------------------------------------------------------------
+// Head to head comparison: error codes vs std::expected vs exceptions vs xerr
+//
+// Every contender propagates a failure through three call levels and the top level handles
+// it. We measure the happy path (nothing fails) and the error path (the lowest level fails).
+//
+// usage: xerr_bench_compare [iterations]
+//-----------------------------------------------------------------------------------------
+#include "xerr.h"
+#include "bench_common.h"
+
+#include <cstdlib>
+
+#if __has_include(<expected>)
+    #include <expected>
+#endif
+
+namespace
+{
+    enum class bench_error : std::uint8_t
+    { OK
+    , FAILURE
+    , NOT_FOUND
+    , IO_ERROR
+    , INVALID
+    };
+
+    // Read through a volatile so the compiler can not tell which path runs
+    volatile int g_FailAt = -1;
+
+    //------------------------------------------------------------------------------------
+    // Error codes
+    //------------------------------------------------------------------------------------
+    namespace codes
+    {
+        XERR_BENCH_NOINLINE bench_error Low(int i, int& Out) noexcept
+        {
+            if (i == g_FailAt) return bench_error::NOT_FOUND;
+            Out = i;
+            return bench_error::OK;
+        }
+
+        XERR_BENCH_NOINLINE bench_error Mid(int i, int& Out) noexcept
+        {
+            if (Low(i, Out) != bench_error::OK) return bench_error::IO_ERROR;
+            ++Out;
+            return bench_error::OK;
+        }
+
+        XERR_BENCH_NOINLINE bench_error High(int i, int& Out) noexcept
+        {
+            if (Mid(i, Out) != bench_error::OK) return bench_error::INVALID;
+            ++Out;
+            return bench_error::OK;
+        }
+    }
+
+    //------------------------------------------------------------------------------------
+    // std::expected
+    //------------------------------------------------------------------------------------
+#if defined(__cpp_lib_expected)
+    namespace expected
+    {
+        XERR_BENCH_NOINLINE std::expected<int, bench_error> Low(int i) noexcept
+        {
+            if (i == g_FailAt) return std::unexpected(bench_error::NOT_FOUND);
+            return i;
+        }
+
+        XERR_BENCH_NOINLINE std::expected<int, bench_error> Mid(int i) noexcept
+        {
+            auto R = Low(i);
+            if (!R) return std::unexpected(bench_error::IO_ERROR);
+            return *R + 1;
+        }
+
+        XERR_BENCH_NOINLINE std::expected<int, bench_error> High(int i) noexcept
+        {
+            auto R = Mid(i);
+            if (!R) return std::unexpected(bench_error::INVALID);
+            return *R + 1;
+        }
+    }
+#endif
+
+    //------------------------------------------------------------------------------------
+    // Exceptions
+    //------------------------------------------------------------------------------------
+    namespace exceptions
+    {
+        struct failure { bench_error m_State; };
+
+        XERR_BENCH_NOINLINE int Low(int i)
+        {
+            if (i == g_FailAt) throw failure{ bench_error::NOT_FOUND };
+            return i;
+        }
+
+        XERR_BENCH_NOINLINE int Mid(int i)
+        {
+            return Low(i) + 1;
+        }
+
+        XERR_BENCH_NOINLINE int High(int i)
+        {
+            return Mid(i) + 1;
+        }
+    }
+
+    //------------------------------------------------------------------------------------
+    // xerr (with chaining of the causes)
+    //------------------------------------------------------------------------------------
+    namespace with_xerr
+    {
+        XERR_BENCH_NOINLINE xerr Low(int i, int& Out) noexcept
+        {
+            if (i == g_FailAt) return xerr::create<bench_error::NOT_FOUND, "Not found|Check the path">();
+            Out = i;
+            return {};
+        }
+
+        XERR_BENCH_NOINLINE xerr Mid(int i, int& Out) noexcept
+        {
+            if (auto Err = Low(i, Out); Err) return xerr::create<bench_error::IO_ERROR, "Read failed">(Err);
+            ++Out;
+            return {};
+        }
+
+        XERR_BENCH_NOINLINE xerr High(int i, int& Out) noexcept
+        {
+            if (auto Err = Mid(i, Out); Err) return xerr::create<bench_error::INVALID, "Request failed">(Err);
+            ++Out;
+            return {};
+        }
+    }
+
+    //------------------------------------------------------------------------------------
+    // xerr::result (value or error in a single register)
+    //------------------------------------------------------------------------------------
+    namespace with_result
+    {
+        XERR_BENCH_NOINLINE xerr::result<int> Low(int i) noexcept
+        {
+            if (i == g_FailAt) return xerr::create<bench_error::NOT_FOUND, "Not found|Check the path">();
+            return i;
+        }
+
+        XERR_BENCH_NOINLINE xerr::result<int> Mid(int i) noexcept
+        {
+            auto R = Low(i);
+            if (!R) return xerr::create<bench_error::IO_ERROR, "Read failed">(R.getError());
+            return *R + 1;
+        }
+
+        XERR_BENCH_NOINLINE xerr::result<int> High(int i) noexcept
+        {
+            auto R = Mid(i);
+            if (!R) return xerr::create<bench_error::INVALID, "Request failed">(R.getError());
+            return *R + 1;
+        }
+    }
+
+    //------------------------------------------------------------------------------------
+
+    void Run(std::size_t Iterations, bool bFail) noexcept
+    {
+        using namespace xerr_bench;
+
+        // Make the lowest level fail on every call (all calls use i == 0) or never
+        g_FailAt = bFail ? 0 : -1;
+
+        PrintResult("error codes", Measure(Iterations, []
+        {
+            int Value = 0;
+            DoNotOptimize(codes::High(0, Value));
+            DoNotOptimize(Value);
+        }));
+
+#if defined(__cpp_lib_expected)
+        PrintResult("std::expected", Measure(Iterations, []
+        {
+            DoNotOptimize(expected::High(0));
+        }));
+#else
+        std::printf("%-48s %12s\n", "std::expected", "n/a (needs C++23)");
+#endif
+
+        // Exceptions are a lot slower on the error path, so run less of them
+        PrintResult("exceptions", Measure(bFail ? Iterations / 100 + 1 : Iterations, []
+        {
+            try
+            {
+                DoNotOptimize(exceptions::High(0));
+            }
+            catch (const exceptions::failure& E)
+            {
+                DoNotOptimize(E.m_State);
+            }
+        }));
+
+        PrintResult("xerr", Measure(Iterations, []
+        {
+            int Value = 0;
+            auto Err = with_xerr::High(0, Value);
+            DoNotOptimize(Err);
+            DoNotOptimize(Value);
+        }));
+
+        PrintResult("xerr::result<int>", Measure(Iterations, []
+        {
+            DoNotOptimize(with_result::High(0));
+        }));
+    }
+}
+
+//-----------------------------------------------------------------------------------------
+
+int main(int argc, const char* argv[])
+{
+    const std::size_t Iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+
+    xerr_bench::PrintHeader("happy path (3 levels, nothing fails)");
+    Run(Iterations, false);
+
+    xerr_bench::PrintHeader("error path (3 levels, the lowest level fails)");
+    Run(Iterations, true);
+
+    return 0;
+}
@@ -0,0 +1,178 @@
+//-----------------------------------------------------------------------------------------
+// Single thread micro benchmarks for the xerr API
+//
+// usage: xerr_bench_single [iterations]
+//-----------------------------------------------------------------------------------------
+#include "xerr.h"
+#include "xerr_sink.h"
+#include "bench_common.h"
+
+#include <cstdlib>
+
+namespace
+{
+    enum class bench_error : std::uint8_t
+    { OK
+    , FAILURE
+    , NOT_FOUND
+    , IO_ERROR
+    };
+
+    //------------------------------------------------------------------------------------
+
+    XERR_BENCH_NOINLINE xerr CreateOk(int i) noexcept
+    {
+        if (i < 0) return xerr::create<bench_error::NOT_FOUND, "Not found|Check the path">();
+        return {};
+    }
+
+    //------------------------------------------------------------------------------------
+
+    XERR_BENCH_NOINLINE xerr Create(void) noexcept
+    {
+        return xerr::create<bench_error::NOT_FOUND, "Not found|Check the path">();
+    }
+
+    //------------------------------------------------------------------------------------
+
+    XERR_BENCH_NOINLINE xerr CreateChained(xerr Prev) noexcept
+    {
+        return xerr::create<bench_error::IO_ERROR, "Read failed|Check the device">(Prev);
+    }
+
+    //------------------------------------------------------------------------------------
+
+    XERR_BENCH_NOINLINE xerr CreateWithArgs(std::string_view Path, int Line) noexcept
+    {
+        return xerr::create<bench_error::NOT_FOUND, "Cannot open {} at line {}|Check the path">(xerr::args(Path, Line));
+    }
+
+    //------------------------------------------------------------------------------------
+
+    void NullCallback(const char*, std::uint8_t, std::string_view, std::uint32_t, std::string_view) noexcept
+    {
+    }
+}
+
+//-----------------------------------------------------------------------------------------
+
+int main(int argc, const char* argv[])
+{
+    using namespace xerr_bench;
+
+    const std::size_t Iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+
+    PrintHeader("xerr single thread");
+
+#if XERR_FLIGHT_RECORDER
+    // Every create<> also writes a record into the mapped file
+    if (xerr_details::g_FlightRecorder.Open("xerr_bench_flight.xefr") == false) return 1;
+#endif
+
+    PrintResult("happy path (return {} + operator bool)", Measure(Iterations, [i = 0]() mutable
+    {
+        auto Err = CreateOk(i++);
+        DoNotOptimize(static_cast<bool>(Err));
+    }));
+
+    PrintResult("create<>", Measure(Iterations, []
+    {
+        DoNotOptimize(Create());
+    }));
+
+    PrintResult("create<> + create<>(PrevError)", Measure(Iterations, []
+    {
+        DoNotOptimize(CreateChained(Create()));
+    }));
+
+    {
+        // Build a chain of 4 errors and walk it
+        auto Err = CreateChained(CreateChained(CreateChained(Create())));
+        PrintResult("ForEachInChain (4 links)", Measure(Iterations, [&]
+        {
+            Err.ForEachInChain([](xerr E) { DoNotOptimize(E.m_pMessage); });
+        }));
+
+        PrintResult("ForEachInChainBackwards (4 links)", Measure(Iterations, [&]
+        {
+            Err.ForEachInChainBackwards([](xerr E) { DoNotOptimize(E.m_pMessage); });
+        }));
+
+        char Buffer[512];
+        PrintResult("Format into a buffer (4 links, TEXT)", Measure(Iterations, [&]
+        {
+            DoNotOptimize(Err.Format(Buffer));
+        }));
+
+        PrintResult("Format into a buffer (4 links, JSON)", Measure(Iterations, [&]
+        {
+            DoNotOptimize(Err.Format(Buffer, xerr::format_style::JSON));
+        }));
+    }
+
+    {
+        xerr Err = Create();
+        DoNotOptimize(Err);
+        PrintResult("getMessage", Measure(Iterations, [&]
+        {
+            DoNotOptimize(Err);
+            DoNotOptimize(Err.getMessage());
+        }));
+
+        PrintResult("getHint", Measure(Iterations, [&]
+        {
+            DoNotOptimize(Err);
+            DoNotOptimize(Err.getHint());
+        }));
+
+        PrintResult("getState", Measure(Iterations, [&]
+        {
+            DoNotOptimize(Err);
+            DoNotOptimize(Err.getState<bench_error>());
+        }));
+
+        PrintResult("Match (4 handlers + otherwise)", Measure(Iterations, [&]
+        {
+            int Route = 0;
+            DoNotOptimize(Err);
+            Err.Match( xerr::on<bench_error::IO_ERROR>([&] { Route = 1; })
+                     , xerr::on<bench_error::NOT_FOUND>([&] { Route = 2; })
+                     , xerr::on<bench_error::FAILURE>([&] { Route = 3; })
+                     , xerr::on<xerr::default_states>([&] { Route = 4; })
+                     , xerr::otherwise([&] { Route = 5; }) );
+            DoNotOptimize(Route);
+        }));
+    }
+
+    PrintResult("create<> with 2 runtime args (never read)", Measure(Iterations, []
+    {
+        DoNotOptimize(CreateWithArgs("assets/level01.bin", 42));
+    }));
+
+    PrintResult("create<> with 2 runtime args + getMessage", Measure(Iterations, []
+    {
+        DoNotOptimize(CreateWithArgs("assets/level01.bin", 42).getMessage());
+    }));
+
+    xerr::m_pCallback = NullCallback;
+    PrintResult("create<> with callback dispatch", Measure(Iterations, []
+    {
+        DoNotOptimize(Create());
+    }));
+
+    PrintResult("create<>(PrevError) with callback dispatch", Measure(Iterations, []
+    {
+        DoNotOptimize(CreateChained(Create()));
+    }));
+
+    // Same callback but delivered by the async sink drain thread
+    xerr_details::g_AsyncSink.Start();
+    PrintResult("create<> with async sink", Measure(Iterations, []
+    {
+        DoNotOptimize(Create());
+    }));
+    xerr_details::g_AsyncSink.Stop();
+    xerr::m_pCallback = nullptr;
+
+    return 0;
+}
@@ -0,0 +1,104 @@
+//-----------------------------------------------------------------------------------------
+// xerr::args
+//
+// Runtime arguments formatted into the message and the hint, the limits of the per-thread
+// arena (other threads, two errors of the same site, entries pushed out of the ring) and
+// an arena that wrapped around many times.
+//-----------------------------------------------------------------------------------------
+#include "xerr.h"
+#include "test_common.h"
+
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace
+{
+    enum class test_error : std::uint8_t
+    { OK
+    , FAILURE
+    , NOT_FOUND
+    };
+
+    //------------------------------------------------------------------------------------
+
+    xerr Open(std::string_view Path, int Retries) noexcept
+    {
+        return xerr::create<test_error::NOT_FOUND, "Cannot open {} after {} tries|Check {}">(xerr::args(Path, Retries, "the path"));
+    }
+
+    //------------------------------------------------------------------------------------
+
+    xerr Fail(int Value) noexcept
+    {
+        return xerr::create<test_error::FAILURE, "Value {}">(xerr::args(Value));
+    }
+}
+
+//-----------------------------------------------------------------------------------------
+
+int main(void)
+{
+    // Message and hint get their arguments
+    {
+        auto Err = Open("level.bin", 3);
+        XERR_CHECK(Err.getMessage() == "Cannot open level.bin after 3 tries");
+        XERR_CHECK(Err.getHint() == "Check the path");
+        XERR_CHECK(Err.getState<test_error>() == test_error::NOT_FOUND);
+        Err.clear();
+    }
+
+    // Negative numbers, strings longer than the 255 characters kept
+    {
+        auto Err = Fail(-42);
+        XERR_CHECK(Err.getMessage() == "Value -42");
+        Err.clear();
+
+        const std::string Long(300, 'x');
+        Err = Open(Long, 1);
+        XERR_CHECK(Err.getMessage() == "Cannot open " + std::string(255, 'x') + " after 1 tries");
+        Err.clear();
+    }
+
+    // Another thread only sees the raw text
+    {
+        auto Err = Fail(7);
+        std::string_view Message;
+        std::thread([&] { Message = Err.getMessage(); }).join();
+        XERR_CHECK(Message == "Value {}");
+        XERR_CHECK(Err.getMessage() == "Value 7");
+        Err.clear();
+    }
+
+    // Two live errors of the same site show the arguments of the newest one
+    {
+        auto Old = Fail(1);
+        auto New = Fail(2);
+        XERR_CHECK(New.getMessage() == "Value 2");
+        XERR_CHECK(Old.getMessage() == "Value 2");
+        Old.clear();
+        New.clear();
+    }
+
+    // The ring wraps around many times, the latest entry is always found and older ones of
+    // other sites fall back to the raw text
+    {
+        auto First = Open("first.bin", 1);
+        auto Err   = xerr{};
+        for (int i = 0; i < 1000; ++i)
+        {
+            Err = Fail(i);
+            XERR_CHECK(Err.getMessage() == "Value " + std::to_string(i));
+            Err.clear();
+        }
+
+        XERR_CHECK(First.getMessage() == "Cannot open {} after {} tries");
+        First.clear();
+
+        Err = Open("second.bin", 2);
+        XERR_CHECK(Err.getMessage() == "Cannot open second.bin after 2 tries");
+        Err.clear();
+    }
+
+    return xerr_test::Result();
+}
@@ -0,0 +1,127 @@
+//-----------------------------------------------------------------------------------------
+// xerr::batch
+//
+// Failures of a loop run on several threads: every failed element is in the bitmap and
+// visited once, Collect gives the lowest ones sorted, only the first keeps its chain so
+// the pool does not drain. FIRST_ERROR stops the loop at the first failure, and a batch
+// can be cleared and reused, also next to another batch on the same thread.
+//-----------------------------------------------------------------------------------------
+#include "xerr_batch.h"
+#include "test_common.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    enum class test_error : std::uint8_t
+    { OK
+    , FAILURE
+    , INVALID
+    };
+
+    constexpr std::size_t count_v   = 10000;
+    constexpr int         threads_v = 8;
+
+    //------------------------------------------------------------------------------------
+
+    xerr Process(std::size_t Index) noexcept
+    {
+        if (Index % 7) return {};
+        auto Err = xerr::create<test_error::INVALID, "Bad record">();
+        return xerr::create<test_error::FAILURE, "Process failed">(Err);
+    }
+
+    //------------------------------------------------------------------------------------
+    // Each thread takes every threads_v-th element
+    void RunLoop(xerr::batch& Batch) noexcept
+    {
+        std::vector<std::thread> Threads;
+        for (int t = 0; t < threads_v; ++t) Threads.emplace_back([&Batch, t]
+        {
+            for (std::size_t i = t; i < count_v; i += threads_v) Batch.Invoke(i, [i] { return Process(i); });
+        });
+        for (auto& Thread : Threads) Thread.join();
+    }
+}
+
+//-----------------------------------------------------------------------------------------
+
+int main(void)
+{
+    constexpr std::size_t failed_v = (count_v + 6) / 7;
+
+    // Every failure recorded once
+    xerr::batch Batch{ count_v };
+    {
+        RunLoop(Batch);
+        XERR_CHECK(Batch);
+        XERR_CHECK(Batch.getFailedCount() == failed_v);
+        XERR_CHECK(Batch.m_LostCount.load() == 0);
+
+        bool bBitmap = true;
+        for (std::size_t i = 0; i < count_v; ++i) bBitmap &= Batch.isFailed(i) == (i % 7 == 0);
+        XERR_CHECK(bBitmap);
+
+        std::vector<int> Seen(count_v, 0);
+        bool             bErrors = true;
+        Batch.ForEach([&](std::size_t Index, xerr Error)
+        {
+            ++Seen[Index];
+            bErrors &= Error.getMessage() == "Process failed";
+        });
+        bool bOnce = true;
+        for (std::size_t i = 0; i < count_v; ++i) bOnce &= Seen[i] == (i % 7 == 0 ? 1 : 0);
+        XERR_CHECK(bOnce && bErrors);
+
+        xerr_details::batch_failure Lowest[16];
+        XERR_CHECK(Batch.Collect(Lowest) == 16);
+        bool bSorted = true;
+        for (std::size_t i = 0; i < 16; ++i) bSorted &= Lowest[i].m_Index == i * 7;
+        XERR_CHECK(bSorted);
+
+        // The first failure kept its chain, the others gave their nodes back
+        std::string Chain;
+        Batch.getFirst().ForEachInChain([&](xerr E) { Chain += E.getMessage(); Chain += ';'; });
+        XERR_CHECK(Chain == "Bad record;Process failed;");
+        XERR_CHECK(Batch.getFirstIndex() % 7 == 0);
+        XERR_CHECK(xerr::m_ChainPool.m_TruncateCount.load() == 0);
+    }
+
+    // Cleared and reused, with another batch used by the same threads in between
+    {
+        Batch.clear();
+        XERR_CHECK(!Batch);
+        XERR_CHECK(Batch.getFailedCount() == 0);
+
+        xerr::batch Other{ count_v };
+        RunLoop(Other);
+        RunLoop(Batch);
+        XERR_CHECK(Batch.getFailedCount() == failed_v);
+        XERR_CHECK(Other.getFailedCount() == failed_v);
+
+        std::size_t nVisited = 0;
+        Batch.ForEach([&](std::size_t, xerr) { ++nVisited; });
+        XERR_CHECK(nVisited == failed_v);
+    }
+
+    // FIRST_ERROR skips what did not start
+    {
+        xerr::batch First{ count_v, xerr::batch::mode::FIRST_ERROR };
+        std::size_t nCalls = 0;
+        for (std::size_t i = 0; i < count_v; ++i) First.Invoke(i, [&, i] { ++nCalls; return Process(i); });
+
+        XERR_CHECK(nCalls == 1);
+        XERR_CHECK(First.isCancelled());
+        XERR_CHECK(First.getFailedCount() == 1);
+        XERR_CHECK(First.getFirstIndex() == 0);
+
+        std::size_t nVisited = 0;
+        First.ForEach([&](std::size_t, xerr) { ++nVisited; });
+        XERR_CHECK(nVisited == 1);
+    }
+
+    return xerr_test::Result();
+}
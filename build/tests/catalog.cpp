@@ -0,0 +1,92 @@
+//-----------------------------------------------------------------------------------------
+// xerr site IDs and the catalog
+//
+// A site ID collision can not be produced with real messages, so the test forges one: a
+// copy of a site with another message but the ID of a real site. The catalog must refuse it
+// and xerr::operator == must still tell the two sites apart. Built with NDEBUG, in debug
+// builds the collision asserts.
+//-----------------------------------------------------------------------------------------
+#include "xerr.h"
+#include "test_common.h"
+
+namespace
+{
+    enum class test_error : std::uint8_t
+    { OK
+    , FAILURE
+    , BAD
+    };
+
+    constexpr static auto& real_v = xerr_details::data_v<"Bad thing|Check the input", test_error::BAD>;
+
+    // Same ID as real_v but another message, what a real hash collision would look like
+    constinit static auto forged_v = []() consteval noexcept
+    {
+        auto Data = xerr_details::data_v<"Other thing|Forged", test_error::BAD>;
+        Data.m_SiteID = real_v.m_SiteID;
+        return Data;
+    }();
+
+    // The same site compiled into another shared object, its own copy of the message
+    constinit static auto copy_v = real_v;
+
+    // Same ID and message but another enum, told apart by the hash of the enum name
+    constinit static auto renamed_v = real_v;
+
+    // Same ID and message but another enum, in a shared object that did not register it: only
+    // the enum UID of the header tells it apart
+    constinit static auto unknown_v = []() consteval noexcept
+    {
+        auto Data = real_v;
+        Data.m_TypeGUID += 1;
+        return Data;
+    }();
+
+    const auto TypeHash = xerr_details::details::getTypeNameHash<test_error>(xerr_details::details::fnv1a_offset_v);
+
+    xerr_details::catalog_entry s_Real   { real_v.m_SiteID,   TypeHash, real_v.m_Message,   nullptr };
+    xerr_details::catalog_entry s_Copy   { copy_v.m_SiteID,   TypeHash, copy_v.m_Message,   nullptr };
+    xerr_details::catalog_entry s_Forged { forged_v.m_SiteID, TypeHash, forged_v.m_Message, nullptr };
+    xerr_details::catalog_entry s_Renamed{ renamed_v.m_SiteID, TypeHash + 1, renamed_v.m_Message, nullptr };
+
+    xerr Wrap(const char* pMessage) noexcept
+    {
+        xerr Err;
+        Err.m_pMessage = pMessage;
+        return Err;
+    }
+}
+
+//-----------------------------------------------------------------------------------------
+
+int main(void)
+{
+    // The forged and renamed sites are collisions, the copy is the same site
+    XERR_CHECK(xerr::m_Catalog.m_nCollisions.load() == 2);
+    XERR_CHECK(xerr::m_Catalog.Find(real_v.m_SiteID) == &s_Real);
+    XERR_CHECK(xerr::m_Catalog.FindSite(forged_v.m_Message) == &s_Forged);
+    XERR_CHECK(xerr_details::catalog::isSameSite(s_Real, s_Copy));
+    XERR_CHECK(xerr_details::catalog::isSameSite(s_Real, s_Renamed) == false);
+
+    // Equality still holds for the real site and its copy, the forged site is another error
+    const auto Real   = Wrap(real_v.m_Message);
+    const auto Copy   = Wrap(copy_v.m_Message);
+    const auto Forged = Wrap(forged_v.m_Message);
+    XERR_CHECK(Real.getSiteID() == Forged.getSiteID());
+    XERR_CHECK(Real == Copy);
+    XERR_CHECK((Real == Forged) == false);
+    XERR_CHECK((Forged == Copy) == false);
+    XERR_CHECK(Forged == Forged);
+    XERR_CHECK((Real == Wrap(renamed_v.m_Message)) == false);
+    XERR_CHECK((Real == Wrap(unknown_v.m_Message)) == false);
+    XERR_CHECK((Copy == Wrap(unknown_v.m_Message)) == false);
+
+    // Only the ID that collided takes the slow compare, other sites keep comparing by ID
+    XERR_CHECK(s_Real.m_bCollided.load());
+    const auto Other = xerr::create<test_error::FAILURE, "Unrelated site">();
+    const auto* pOther = xerr::m_Catalog.Find(Other.getSiteID());
+    XERR_CHECK(pOther && pOther->m_bCollided.load() == false);
+    XERR_CHECK(Other == Other);
+
+    return xerr_test::Result();
+}
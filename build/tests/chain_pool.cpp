@@ -0,0 +1,173 @@
+//-----------------------------------------------------------------------------------------
+// chain_pool magazines
+//
+// 64 threads build and release a 16-link chain, then stay idle with their nodes cached.
+// The pool (1024 nodes by default) must still give the main thread every node it has:
+// the magazines hold at most a quarter of it and the rest is reclaimed when the global
+// list runs dry. Then busy threads churn short chains while the main thread keeps draining
+// the pool, Reclaim must never take a node from a magazine in use.
+//-----------------------------------------------------------------------------------------
+#include "xerr.h"
+#include "test_common.h"
+
+#include <atomic>
+#include <latch>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    enum class test_error : std::uint8_t
+    { OK
+    , FAILURE
+    , LINK
+    };
+
+    constexpr int threads_v = 64;
+    constexpr int links_v   = 16;
+
+    //------------------------------------------------------------------------------------
+
+    xerr BuildChain(int nLinks) noexcept
+    {
+        xerr Err = xerr::create<test_error::LINK, "Link">();
+        for (int i = 1; i < nLinks; ++i) Err = xerr::create<test_error::LINK, "Link">(Err);
+        return Err;
+    }
+
+    //------------------------------------------------------------------------------------
+
+    int CountLinks(xerr Err) noexcept
+    {
+        int n = 0;
+        Err.ForEachInChain([&](xerr) { ++n; });
+        return n;
+    }
+
+    //------------------------------------------------------------------------------------
+
+    std::uint64_t getLostLinks(void) noexcept
+    {
+        return xerr::m_ChainPool.m_TruncateCount.load() + xerr::m_ChainPool.m_DropCount.load();
+    }
+
+    //------------------------------------------------------------------------------------
+    // Free nodes in the global list and the magazines, -1 if a node is in there twice
+    int CountFreeNodes(void) noexcept
+    {
+        using pool = xerr_details::chain_pool;
+
+        std::vector<bool> Seen(pool::capacity_v);
+        int               n    = 0;
+        const auto        Mark = [&](pool::index Index) noexcept
+        {
+            if (Seen[static_cast<std::size_t>(Index)]) return false;
+            Seen[static_cast<std::size_t>(Index)] = true;
+            ++n;
+            return true;
+        };
+
+        for (auto i = pool::UnpackIndex(xerr::m_ChainPool.m_Empty.load()); i != -1; i = xerr::m_ChainPool[i].m_iNext)
+            if (Mark(i) == false) return -1;
+
+        for (const auto& Magazine : xerr::m_ChainPool.m_Magazines)
+            for (std::int16_t i = 0; i < Magazine.m_Count; ++i)
+                if (Mark(Magazine.m_Index[static_cast<std::size_t>(i)]) == false) return -1;
+
+        return n;
+    }
+}
+
+//-----------------------------------------------------------------------------------------
+
+int main(void)
+{
+    using pool = xerr_details::chain_pool;
+
+    std::latch               Built   { threads_v };
+    std::latch               Done    { 1 };
+    std::vector<std::thread> Threads;
+
+    for (int i = 0; i < threads_v; ++i) Threads.emplace_back([&]
+    {
+        auto Err = BuildChain(links_v);
+        XERR_CHECK(CountLinks(Err) == links_v);
+        Err.clear();
+
+        Built.count_down();
+        Done.wait();
+    });
+
+    Built.wait();
+
+    // Every worker is idle, the magazines hold their nodes but never more than a quarter of the pool
+    std::size_t nTaken = 0, nCached = 0;
+    for (const auto& Magazine : xerr::m_ChainPool.m_Magazines)
+    {
+        if (Magazine.m_bTaken.load() == false) continue;
+        ++nTaken;
+        nCached += static_cast<std::size_t>(Magazine.m_Count);
+    }
+    XERR_CHECK(nTaken <= pool::magazine_count_v);
+    XERR_CHECK(nCached <= pool::capacity_v / 4);
+    XERR_CHECK(getLostLinks() == 0);
+
+    // A short chain keeps both links
+    {
+        auto Err = BuildChain(2);
+        XERR_CHECK(CountLinks(Err) == 2);
+        XERR_CHECK(getLostLinks() == 0);
+        Err.clear();
+    }
+
+    // The whole pool is there, the cached nodes included
+    {
+        auto Err = BuildChain(static_cast<int>(pool::capacity_v));
+        XERR_CHECK(CountLinks(Err) == static_cast<int>(pool::capacity_v));
+        XERR_CHECK(getLostLinks() == 0);
+        XERR_CHECK(nCached == 0 || xerr::m_ChainPool.m_ReclaimCount.load() > 0);
+
+        // Only now is the pool exhausted
+        Err = xerr::create<test_error::LINK, "Link">(Err);
+        XERR_CHECK(xerr::m_ChainPool.m_TruncateCount.load() == 1);
+        Err.clear();
+    }
+
+    Done.count_down();
+    for (auto& Thread : Threads) Thread.join();
+
+    // The threads are gone, their magazines are free again
+    for (const auto& Magazine : xerr::m_ChainPool.m_Magazines)
+        if (&Magazine != xerr_details::g_Magazine.m_pMagazine) XERR_CHECK(Magazine.m_bTaken.load() == false);
+
+    // Busy threads against a main thread that keeps running the pool dry, links get truncated
+    // but no node may end up in two places
+    {
+        std::atomic<bool>        bStop{ false };
+        std::vector<std::thread> Busy;
+
+        for (int i = 0; i < 8; ++i) Busy.emplace_back([&bStop, nLinks = 1 + i % 4]
+        {
+            while (bStop.load(std::memory_order_relaxed) == false)
+            {
+                auto Err = BuildChain(nLinks);
+                XERR_CHECK(CountLinks(Err) <= nLinks);
+                Err.clear();
+            }
+        });
+
+        for (int i = 0; i < 200; ++i)
+        {
+            auto Err = BuildChain(static_cast<int>(pool::capacity_v));
+            XERR_CHECK(CountLinks(Err) <= static_cast<int>(pool::capacity_v));
+            Err.clear();
+        }
+
+        bStop.store(true, std::memory_order_relaxed);
+        for (auto& Thread : Busy) Thread.join();
+    }
+    XERR_CHECK(xerr::m_ChainPool.m_ReclaimCount.load() > 0);
+    XERR_CHECK(CountFreeNodes() == static_cast<int>(pool::capacity_v));
+
+    return xerr_test::Result();
+}
@@ -0,0 +1,110 @@
+//-----------------------------------------------------------------------------------------
+// chain_pool exhaustion policies
+//
+// Built with a 64-node pool. A chain that outgrows it loses its oldest causes with
+// TRUNCATE_OLDEST or keeps them and skips the new links with DROP_NEW, each counted.
+// "exhaustion fail_fast" checks that FAIL_FAST aborts.
+//-----------------------------------------------------------------------------------------
+#include "xerr.h"
+#include "test_common.h"
+
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+
+namespace
+{
+    enum class test_error : std::uint8_t
+    { OK
+    , FAILURE
+    , LINK
+    };
+
+    using pool = xerr_details::chain_pool;
+
+    constexpr int links_v = 80;
+
+    //------------------------------------------------------------------------------------
+
+    xerr BuildChain(void) noexcept
+    {
+        xerr Err = xerr::create<test_error::LINK, "Root">();
+        for (int i = 2; i < links_v; ++i) Err = xerr::create<test_error::LINK, "Link">(Err);
+        return xerr::create<test_error::LINK, "Last">(Err);
+    }
+
+    //------------------------------------------------------------------------------------
+
+    int CountLinks(xerr Err) noexcept
+    {
+        int n = 0;
+        Err.ForEachInChain([&](xerr) { ++n; });
+        return n;
+    }
+
+    //------------------------------------------------------------------------------------
+    // Root cause first, newest last
+    std::string_view getLink(xerr Err, int Index) noexcept
+    {
+        std::string_view Message;
+        int              i = 0;
+        Err.ForEachInChain([&](xerr E) { if (i++ == Index) Message = E.getMessage(); });
+        return Message;
+    }
+
+    //------------------------------------------------------------------------------------
+
+    extern "C" void OnAbort(int) noexcept
+    {
+        std::_Exit(xerr::m_ChainPool.m_FailFastCount.load() == 1 ? 0 : 1);
+    }
+}
+
+//-----------------------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+    static_assert(pool::capacity_v == 64);
+
+    if (argc > 1 && std::strcmp(argv[1], "fail_fast") == 0)
+    {
+        std::signal(SIGABRT, OnAbort);
+        xerr::m_ChainPool.m_ExhaustionPolicy = pool::exhaustion_policy::FAIL_FAST;
+        (void)BuildChain();
+        return 1;
+    }
+
+    // The chain keeps its newest links, the root cause goes first
+    {
+        auto Err = BuildChain();
+        XERR_CHECK(CountLinks(Err) == int{ pool::capacity_v });
+        XERR_CHECK(getLink(Err, 0) == "Link");
+        XERR_CHECK(getLink(Err, pool::capacity_v - 1) == "Last");
+        XERR_CHECK(xerr::m_ChainPool.m_TruncateCount.load() == links_v - pool::capacity_v);
+        XERR_CHECK(xerr::m_ChainPool.m_DropCount.load() == 0);
+        Err.clear();
+    }
+
+    // The chain keeps its oldest links and skips the ones that do not fit
+    {
+        xerr::m_ChainPool.m_ExhaustionPolicy = pool::exhaustion_policy::DROP_NEW;
+        auto Err = BuildChain();
+        XERR_CHECK(CountLinks(Err) == int{ pool::capacity_v });
+        XERR_CHECK(getLink(Err, 0) == "Root");
+        XERR_CHECK(getLink(Err, pool::capacity_v - 1) == "Link");
+        XERR_CHECK(Err.getMessage() == "Last");
+        XERR_CHECK(xerr::m_ChainPool.m_DropCount.load() == links_v - pool::capacity_v);
+        Err.clear();
+    }
+
+    // Every node went back to the pool
+    {
+        auto Err = BuildChain();
+        XERR_CHECK(CountLinks(Err) == int{ pool::capacity_v });
+        Err.clear();
+        XERR_CHECK(xerr::m_ChainPool.m_FailFastCount.load() == 0);
+    }
+
+    return xerr_test::Result();
+}
@@ -0,0 +1,142 @@
+//-----------------------------------------------------------------------------------------
+// xerr_details::g_FlightRecorder
+//
+// Built with XERR_FLIGHT_RECORDER=1. A second Open is refused while the recorder is open,
+// and the file holds the catalog and the rings: one per thread up to MaxThreads, records
+// wrapped around, chain links. The flight_reader test then decodes the same file.
+//-----------------------------------------------------------------------------------------
+#include "xerr.h"
+#include "test_common.h"
+
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+// Not in the anonymous namespace, each compiler names that one differently
+enum class test_error : std::uint8_t
+{ OK
+, FAILURE
+, IO
+};
+
+namespace
+{
+    using recorder = xerr_details::flight_recorder;
+
+    constexpr auto path_v = "xerr_test_flight.xefr";
+
+    xerr Read(void) noexcept
+    {
+        return xerr::create<test_error::IO, "Cannot read|Check the disk">();
+    }
+
+    //------------------------------------------------------------------------------------
+
+    xerr Load(void) noexcept
+    {
+        auto Err = Read();
+        return xerr::create<test_error::FAILURE, "Load failed">(Err);
+    }
+
+    //------------------------------------------------------------------------------------
+
+    std::vector<std::byte> ReadFile(void) noexcept
+    {
+        std::vector<std::byte> Data;
+        if (std::FILE* pFile = std::fopen(path_v, "rb"); pFile)
+        {
+            std::byte Buffer[4096];
+            for (std::size_t n; (n = std::fread(Buffer, 1, sizeof(Buffer), pFile)) > 0; )
+                Data.insert(Data.end(), Buffer, Buffer + n);
+            std::fclose(pFile);
+        }
+        return Data;
+    }
+
+    //------------------------------------------------------------------------------------
+
+    template< typename T >
+    T At(const std::vector<std::byte>& Data, std::size_t Offset) noexcept
+    {
+        T Value;
+        std::memcpy(&Value, &Data[Offset], sizeof(T));
+        return Value;
+    }
+}
+
+//-----------------------------------------------------------------------------------------
+
+int main(void)
+{
+    auto& Recorder = xerr_details::g_FlightRecorder;
+
+    // Only Close can take the file away
+    XERR_CHECK(Recorder.Open(path_v, 2, 4));
+    XERR_CHECK(Recorder.Open(path_v, 2, 4) == false);
+    XERR_CHECK(Recorder.isOpen());
+    Recorder.Close();
+    XERR_CHECK(Recorder.isOpen() == false);
+    XERR_CHECK(Recorder.Open(path_v, 2, 4));
+
+    // The main thread wraps its ring, one thread fits and the last one is out of rings
+    for (int i = 0; i < 5; ++i) (void)Read();
+    auto Err = Load();
+    std::thread([] { (void)Read(); }).join();
+    std::thread([] { (void)Read(); }).join();
+
+    const auto ReadID = Read().getSiteID();
+    const auto LoadID = Err.getSiteID();
+    Err.clear();
+    Recorder.Close();
+
+    const auto Data = ReadFile();
+    XERR_CHECK(Data.size() > sizeof(recorder::file_header));
+    if (Data.size() <= sizeof(recorder::file_header)) return xerr_test::Result();
+
+    const auto Header = At<recorder::file_header>(Data, 0);
+    XERR_CHECK(Header.m_Magic == recorder::magic_v);
+    XERR_CHECK(Header.m_Version == recorder::version_v);
+    XERR_CHECK(Header.m_MaxThreads == 2);
+    XERR_CHECK(Header.m_RecordsPerThread == 4);
+    XERR_CHECK(Header.m_nThreads == 3);
+
+    // Both sites are in the catalog, with their state and full message
+    int nFound = 0;
+    for (std::size_t Offset = Header.m_CatalogOffset; Offset < Header.m_CatalogOffset + Header.m_CatalogSize; )
+    {
+        const auto  Entry = At<recorder::catalog_header>(Data, Offset);
+        const auto* pText = reinterpret_cast<const char*>(&Data[Offset + sizeof(Entry)]);
+        const std::string_view Name   { pText, Entry.m_StateNameLength };
+        const std::string_view Message{ pText + Entry.m_StateNameLength, Entry.m_MessageLength };
+
+        if (Entry.m_SiteID == ReadID) nFound += Name == "test_error::IO"      && Message == "Cannot read|Check the disk" && Entry.m_State == 2;
+        if (Entry.m_SiteID == LoadID) nFound += Name == "test_error::FAILURE" && Message == "Load failed"                && Entry.m_State == 1;
+        Offset += sizeof(Entry) + Entry.m_StateNameLength + Entry.m_MessageLength;
+    }
+    XERR_CHECK(nFound == 2);
+
+    // Main thread: 5 + 2 errors before the threads and one after, only the last 4 are kept
+    const std::size_t RingStride = sizeof(recorder::ring_header) + 4 * sizeof(recorder::record);
+    auto Record = [&](std::uint32_t iRing, std::uint64_t Index)
+    {
+        return At<recorder::record>(Data, Header.m_RingsOffset + iRing * RingStride + sizeof(recorder::ring_header) + (Index % 4) * sizeof(recorder::record));
+    };
+
+    const auto Main = At<recorder::ring_header>(Data, Header.m_RingsOffset);
+    XERR_CHECK(Main.m_Head == 8);
+    for (std::uint64_t i = 4; i < 8; ++i) XERR_CHECK(Record(0, i).m_Sequence == i + 1);
+
+    const auto Chained = Record(0, 6);
+    XERR_CHECK(Chained.m_SiteID == LoadID);
+    XERR_CHECK(Chained.m_State == 1);
+    XERR_CHECK(Chained.m_nLinks == 1 && Chained.m_Links[0] == ReadID);
+    XERR_CHECK(Record(0, 7).m_SiteID == ReadID && Record(0, 7).m_nLinks == 0);
+
+    const auto Second = At<recorder::ring_header>(Data, Header.m_RingsOffset + RingStride);
+    XERR_CHECK(Second.m_Head == 1);
+    XERR_CHECK(Second.m_ThreadID != Main.m_ThreadID);
+    XERR_CHECK(Record(1, 0).m_SiteID == ReadID && Record(1, 0).m_Sequence == 1);
+
+    return xerr_test::Result();
+}
@@ -0,0 +1,111 @@
+//-----------------------------------------------------------------------------------------
+// xerr::Format, xerr::FormatTo and std::formatter<xerr>
+//
+// The three layouts of a chain, site IDs, truncation to the buffer, and the format specs
+// std::format accepts and refuses. The std::format part only builds with a standard library
+// that has <format>.
+//-----------------------------------------------------------------------------------------
+#include "xerr_format.h"
+#include "test_common.h"
+
+#include <cstdio>
+#include <iterator>
+#include <string>
+
+// Not in the anonymous namespace, each compiler names that one differently
+enum class test_error : std::uint8_t
+{ OK
+, FAILURE
+, NOT_FOUND
+};
+
+namespace
+{
+    xerr Load(void) noexcept
+    {
+        auto Err = xerr::create<test_error::NOT_FOUND, "File not found|Check path">();
+        return xerr::create<test_error::FAILURE, "Load failed">(Err);
+    }
+
+    //------------------------------------------------------------------------------------
+
+    std::string SiteID(xerr Err) noexcept
+    {
+        char Buffer[32];
+        std::snprintf(Buffer, sizeof(Buffer), "0x%016llx", static_cast<unsigned long long>(Err.getSiteID()));
+        return Buffer;
+    }
+
+#if defined(__cpp_lib_format)
+    bool isRefused(std::string_view Spec, xerr Err)
+    {
+        try
+        {
+            (void)std::vformat(Spec, std::make_format_args(Err));
+            return false;
+        }
+        catch (const std::format_error&)
+        {
+            return true;
+        }
+    }
+#endif
+}
+
+//-----------------------------------------------------------------------------------------
+
+int main(void)
+{
+    char Buffer[512];
+
+    // The three layouts, the latest error first
+    {
+        auto Err = Load();
+        XERR_CHECK(Err.Format(Buffer) == "test_error::FAILURE: Load failed\n  caused by test_error::NOT_FOUND: File not found (Check path)");
+        XERR_CHECK(Err.Format(Buffer, xerr::format_style::LINE) == "test_error::FAILURE: Load failed <- test_error::NOT_FOUND: File not found (Check path)");
+
+        // ForEachInChain starts with the root cause
+        std::string Sites[2];
+        int         iSite = 0;
+        Err.ForEachInChain([&](xerr E) { Sites[iSite++] = SiteID(E); });
+        XERR_CHECK(Err.Format(Buffer, xerr::format_style::JSON, true)
+            == R"([{"state":"test_error::FAILURE","code":1,"message":"Load failed","hint":"","site":")" + Sites[1]
+             + R"("},{"state":"test_error::NOT_FOUND","code":2,"message":"File not found","hint":"Check path","site":")" + Sites[0]
+             + R"("}])");
+
+        // FormatTo writes the same text to any output iterator
+        std::string Text;
+        Err.FormatTo(std::back_inserter(Text), xerr::format_style::LINE);
+        XERR_CHECK(Text == Err.Format(Buffer, xerr::format_style::LINE));
+
+        // Truncated to the buffer and still null terminated
+        const auto Short = Err.Format(std::span<char>(Buffer, 10));
+        XERR_CHECK(Short == "test_erro");
+        XERR_CHECK(Buffer[9] == 0);
+        XERR_CHECK(Err.Format(std::span<char>{}).empty());
+
+        Err.clear();
+        XERR_CHECK(Err.Format(Buffer) == "OK");
+    }
+
+#if defined(__cpp_lib_format)
+    // std::format uses the same layouts
+    {
+        auto Err = Load();
+        XERR_CHECK(std::format("{}", Err)    == Err.Format(Buffer));
+        XERR_CHECK(std::format("{:t}", Err)  == Err.Format(Buffer));
+        XERR_CHECK(std::format("{:l}", Err)  == Err.Format(Buffer, xerr::format_style::LINE));
+        XERR_CHECK(std::format("{:js}", Err) == Err.Format(Buffer, xerr::format_style::JSON, true));
+        XERR_CHECK(std::format("{:s}", Err)  == Err.Format(Buffer, xerr::format_style::TEXT, true));
+
+        // At most one style followed by an optional s
+        XERR_CHECK(isRefused("{:jl}", Err));
+        XERR_CHECK(isRefused("{:ss}", Err));
+        XERR_CHECK(isRefused("{:sj}", Err));
+        XERR_CHECK(isRefused("{:x}", Err));
+        Err.clear();
+    }
+#endif
+
+    return xerr_test::Result();
+}
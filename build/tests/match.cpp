@@ -0,0 +1,102 @@
+//-----------------------------------------------------------------------------------------
+// xerr::Match
+//
+// Routing to the handler of a state, of a whole enum and to otherwise, the forms a handler
+// can take, and handlers passed as lvalues: a mutable one keeps its state between calls,
+// a const one is called through its const call operator.
+//-----------------------------------------------------------------------------------------
+#include "xerr.h"
+#include "test_common.h"
+
+namespace
+{
+    enum class file_error : std::uint8_t
+    { OK
+    , FAILURE
+    , NOT_FOUND
+    , DENIED
+    };
+
+    enum class net_error : std::uint8_t
+    { OK
+    , FAILURE
+    , TIMEOUT
+    };
+
+    //------------------------------------------------------------------------------------
+
+    int Route(xerr Err) noexcept
+    {
+        int Result = 0;
+        const bool bHandled = Err.Match( xerr::on<file_error::NOT_FOUND>([&] { Result = 1; })
+                                       , xerr::on<file_error>([&](file_error State) { Result = 10 + static_cast<int>(State); })
+                                       , xerr::on<net_error::TIMEOUT>([&](xerr E) { Result = E.getState<net_error>() == net_error::TIMEOUT ? 3 : -1; })
+                                       , xerr::otherwise([&] { Result = 4; })
+                                       );
+        return bHandled ? Result : -1;
+    }
+
+    //------------------------------------------------------------------------------------
+
+    struct const_handler
+    {
+        void operator()(void) const noexcept { ++*m_pCount; }
+        void operator()(void)       noexcept { m_bNonConst = true; }
+
+        int*    m_pCount;
+        bool    m_bNonConst = false;
+    };
+}
+
+//-----------------------------------------------------------------------------------------
+
+int main(void)
+{
+    // One state, the rest of the enum, another enum, everything else
+    XERR_CHECK(Route(xerr::create<file_error::NOT_FOUND, "Missing">()) == 1);
+    XERR_CHECK(Route(xerr::create<file_error::DENIED, "Denied">()) == 13);
+    XERR_CHECK(Route(xerr::create<file_error::FAILURE, "Failed">()) == 11);
+    XERR_CHECK(Route(xerr::create<net_error::TIMEOUT, "Timeout">()) == 3);
+    XERR_CHECK(Route(xerr::create<net_error::FAILURE, "Down">()) == 4);
+    XERR_CHECK(Route(xerr::create<xerr::default_states::FAILURE, "Generic">()) == 4);
+    XERR_CHECK(Route(xerr{}) == -1);
+
+    // Without otherwise an unhandled state returns false
+    {
+        auto Err   = xerr::create<net_error::FAILURE, "Down">();
+        int  Count = 0;
+        XERR_CHECK(Err.Match(xerr::on<net_error::TIMEOUT>([&] { ++Count; })) == false);
+        XERR_CHECK(Count == 0);
+        Err.clear();
+    }
+
+    // A mutable handler passed as an lvalue is called in place
+    {
+        auto Err  = xerr::create<file_error::DENIED, "Denied">();
+        auto Case = xerr::on<file_error::DENIED>([n = 0]() mutable noexcept { return ++n; });
+        XERR_CHECK(Err.Match(Case));
+        XERR_CHECK(Err.Match(Case));
+        XERR_CHECK(Case.m_Callback() == 3);
+        Err.clear();
+    }
+
+    // A const handler only sees its const call operator
+    {
+        auto       Err   = xerr::create<file_error::NOT_FOUND, "Missing">();
+        int        Count = 0;
+        const auto Case  = xerr::on<file_error::NOT_FOUND>(const_handler{ &Count });
+        const auto Other = xerr::otherwise(const_handler{ &Count });
+        XERR_CHECK(Err.Match(Case, Other));
+        XERR_CHECK(Count == 1);
+        XERR_CHECK(Case.m_Callback.m_bNonConst == false);
+
+        Err.clear();
+        Err = xerr::create<net_error::TIMEOUT, "Timeout">();
+        XERR_CHECK(Err.Match(Case, Other));
+        XERR_CHECK(Count == 2);
+        XERR_CHECK(Other.m_Callback.m_bNonConst == false);
+        Err.clear();
+    }
+
+    return xerr_test::Result();
+}
@@ -0,0 +1,8 @@
+#
+# cmake -DFILE=<binary> -DTEXT=<string> -P not_in_binary.cmake
+# Fails when the printable strings of FILE contain TEXT
+#
+file(STRINGS "${FILE}" Found REGEX "${TEXT}")
+if(Found)
+  message(FATAL_ERROR "\"${TEXT}\" found in ${FILE}")
+endif()
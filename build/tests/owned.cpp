@@ -0,0 +1,118 @@
+//-----------------------------------------------------------------------------------------
+// xerr::owned
+//
+// An owned error takes the chain of its thread and keeps it while the thread moves on,
+// carries it to another thread, moves, gives it back with Resume and returns its nodes
+// to the pool when it goes away.
+//-----------------------------------------------------------------------------------------
+#include "xerr.h"
+#include "test_common.h"
+
+#include <string>
+#include <thread>
+#include <utility>
+
+namespace
+{
+    enum class test_error : std::uint8_t
+    { OK
+    , FAILURE
+    , NOT_FOUND
+    };
+
+    xerr::owned Load(void) noexcept
+    {
+        auto Err = xerr::create<test_error::NOT_FOUND, "Missing">();
+        return xerr::create<test_error::FAILURE, "Load failed">(Err);
+    }
+
+    //------------------------------------------------------------------------------------
+
+    template< typename T >
+    std::string Chain(const T& Err) noexcept
+    {
+        std::string Text;
+        Err.ForEachInChain([&](xerr E) { Text += Text.empty() ? "" : " <- "; Text += E.getMessage(); });
+        return Text;
+    }
+}
+
+//-----------------------------------------------------------------------------------------
+
+int main(void)
+{
+    // The thread moves on, the owned chain stays
+    {
+        auto Err = Load();
+        XERR_CHECK(Err && Err.hasChain());
+        XERR_CHECK(Err.get().getState<test_error>() == test_error::FAILURE);
+
+        auto Other = xerr::create<test_error::NOT_FOUND, "Other">();
+        Other      = xerr::create<test_error::FAILURE, "Other failed">(Other);
+        XERR_CHECK(Chain(Err) == "Missing <- Load failed");
+        XERR_CHECK(Chain(Other) == "Other <- Other failed");
+        Other.clear();
+    }
+
+    // Another thread reads it
+    {
+        auto        Err = Load();
+        std::string Text;
+        std::thread([&] { Text = Chain(Err); }).join();
+        XERR_CHECK(Text == "Missing <- Load failed");
+
+        std::string Backwards;
+        Err.ForEachInChainBackwards([&](xerr E) { Backwards += E.getMessage(); });
+        XERR_CHECK(Backwards == "Load failedMissing");
+    }
+
+    // Moves leave the source empty
+    {
+        auto Err   = Load();
+        auto Moved = std::move(Err);
+        XERR_CHECK(!Err && Err.hasChain() == false);
+        XERR_CHECK(Chain(Moved) == "Missing <- Load failed");
+
+        xerr::owned Assigned;
+        Assigned = std::move(Moved);
+        XERR_CHECK(!Moved);
+        XERR_CHECK(Chain(Assigned) == "Missing <- Load failed");
+    }
+
+    // Resume gives the chain back to the thread to keep chaining
+    {
+        auto Owned = Load();
+        auto Err   = xerr::create<test_error::FAILURE, "Frame failed">(Owned.Resume());
+        XERR_CHECK(!Owned);
+        XERR_CHECK(Chain(Err) == "Missing <- Load failed <- Frame failed");
+        Err.clear();
+    }
+
+    // A lone error has no chain, an error that is not the latest of the thread does not take its chain
+    {
+        xerr::owned Lone{ xerr::create<test_error::NOT_FOUND, "Missing">() };
+        XERR_CHECK(Lone.hasChain() == false);
+        XERR_CHECK(Chain(Lone) == "Missing");
+
+        auto Old    = xerr::create<test_error::NOT_FOUND, "Old">();
+        auto Latest = xerr::create<test_error::NOT_FOUND, "Missing">();
+        Latest      = xerr::create<test_error::FAILURE, "Latest">(Latest);
+        xerr::owned Stale{ Old };
+        XERR_CHECK(Stale.hasChain() == false);
+        XERR_CHECK(Chain(Latest) == "Missing <- Latest");
+        Latest.clear();
+    }
+
+    // The nodes go back to the pool
+    {
+        for (std::size_t i = 0; i < 4 * xerr_details::chain_pool::capacity_v; ++i)
+        {
+            auto Err = Load();
+            if (i % 2) Err.clear();
+        }
+        XERR_CHECK(xerr::m_ChainPool.m_TruncateCount.load() == 0);
+        XERR_CHECK(xerr::m_ChainPool.m_DropCount.load() == 0);
+    }
+
+    return xerr_test::Result();
+}
@@ -0,0 +1,78 @@
+//-----------------------------------------------------------------------------------------
+// Rate limited reporting (XERR_REPORT_RATE)
+//
+// Several threads hammer the same site. Every error is either reported or counted in a
+// "(N suppressed)" summary that names the site, whichever thread registered it. Build it
+// with -fsanitize=thread to check the first reports of a site against each other.
+//-----------------------------------------------------------------------------------------
+#include "xerr_report_limits.h"
+#include "test_common.h"
+
+#include <atomic>
+#include <charconv>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    enum class test_error : std::uint8_t
+    { OK
+    , FAILURE
+    , IO
+    };
+
+    constexpr int threads_v = 8;
+    constexpr int errors_v  = 1000;
+
+    std::atomic<std::uint64_t>  g_nReported     { 0 };
+    std::atomic<std::uint64_t>  g_nSuppressed   { 0 };
+    std::atomic<std::uint64_t>  g_nBadSummaries { 0 };
+
+    //------------------------------------------------------------------------------------
+
+    void Callback(const char* pEnumValue, std::uint8_t State, std::string_view Message, std::uint32_t Line, std::string_view) noexcept
+    {
+        if (Line)
+        {
+            g_nReported.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        // "io {} (N suppressed)", the message is not formatted
+        constexpr std::string_view Prefix = "io {} (";
+        std::uint64_t Count = 0;
+        if (std::string_view{ pEnumValue }.ends_with("test_error::IO") == false || State != static_cast<std::uint8_t>(test_error::IO) || Message.starts_with(Prefix) == false
+         || std::from_chars(Message.data() + Prefix.size(), Message.data() + Message.size(), Count).ec != std::errc{})
+        {
+            g_nBadSummaries.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        g_nSuppressed.fetch_add(Count, std::memory_order_relaxed);
+    }
+}
+
+//-----------------------------------------------------------------------------------------
+
+int main(void)
+{
+    static_assert(xerr_details::site_limiter::rate_v != 0, "build with XERR_REPORT_RATE");
+
+    xerr::m_pCallback = Callback;
+
+    std::vector<std::thread> Threads;
+    for (int i = 0; i < threads_v; ++i) Threads.emplace_back([i]
+    {
+        for (int n = 0; n < errors_v; ++n) (void)xerr::create<test_error::IO, "io {}">(xerr::args(i));
+    });
+    for (auto& Thread : Threads) Thread.join();
+
+    xerr_details::g_ReportLimits.Flush();
+    xerr::m_pCallback = nullptr;
+
+    XERR_CHECK(g_nBadSummaries.load() == 0);
+    XERR_CHECK(g_nReported.load() >= xerr_details::site_limiter::burst_v);
+    XERR_CHECK(g_nReported.load() + g_nSuppressed.load() == threads_v * errors_v);
+
+    return xerr_test::Result();
+}
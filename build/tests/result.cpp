@@ -0,0 +1,146 @@
+//-----------------------------------------------------------------------------------------
+// xerr::result
+//
+// Which types pack into the message pointer, values that round trip through the packed
+// word (limits, negative numbers, bools, enums, pointers), errors that keep chaining, and
+// the unpacked layout constructing and destroying its value exactly once.
+//-----------------------------------------------------------------------------------------
+#include "xerr.h"
+#include "test_common.h"
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <utility>
+
+namespace
+{
+    enum class test_error : std::uint8_t
+    { OK
+    , FAILURE
+    , INVALID
+    };
+
+    enum class color : std::int8_t
+    { RED  = -1
+    , BLUE = 127
+    };
+
+    // Counts the live instances, the unpacked result must not leak or destroy twice
+    struct tracked
+    {
+        tracked             (int V)                     noexcept : m_Value{ V } { ++s_nAlive; }
+        tracked             (const tracked& O)          noexcept : m_Value{ O.m_Value } { ++s_nAlive; }
+        tracked             (tracked&& O)               noexcept : m_Value{ std::exchange(O.m_Value, -1) } { ++s_nAlive; }
+        tracked& operator = (const tracked&)            noexcept = default;
+        tracked& operator = (tracked&&)                 noexcept = default;
+       ~tracked             (void)                      noexcept { --s_nAlive; }
+
+        int                 m_Value;
+        inline static int   s_nAlive = 0;
+    };
+
+    static_assert(sizeof(xerr::result<int>)             == sizeof(void*));
+    static_assert(sizeof(xerr::result<bool>)            == sizeof(void*));
+    static_assert(sizeof(xerr::result<color>)           == sizeof(void*));
+    static_assert(sizeof(xerr::result<const int*>)      == sizeof(void*));
+    static_assert(xerr::result<std::uint8_t>::packed_v);
+    static_assert(xerr::result<char*>::packed_v == false);                  // Odd addresses are valid
+    static_assert(xerr::result<std::uintptr_t>::packed_v == false);         // No spare bit
+    static_assert(xerr::result<std::string>::packed_v == false);
+    static_assert(std::is_trivially_copyable_v<xerr::result<double>>);
+
+    //------------------------------------------------------------------------------------
+
+    xerr::result<int> Parse(std::string_view Text) noexcept
+    {
+        if (Text.empty()) return xerr::create<test_error::INVALID, "Empty">();
+        int Value = 0;
+        for (auto c : Text) Value = Value * 10 + (c - '0');
+        return Value;
+    }
+
+    //------------------------------------------------------------------------------------
+
+    xerr::result<int> Doubled(std::string_view Text) noexcept
+    {
+        auto Value = Parse(Text);
+        if (!Value) return xerr::create<test_error::FAILURE, "Doubled failed">(Value.getError());
+        return *Value * 2;
+    }
+
+    //------------------------------------------------------------------------------------
+
+    template< typename T >
+    bool RoundTrips(T Value) noexcept
+    {
+        xerr::result<T> R{ Value };
+        return R.hasValue() && R.getValue() == Value && !R.getError();
+    }
+}
+
+//-----------------------------------------------------------------------------------------
+
+int main(void)
+{
+    // Packed values
+    XERR_CHECK(RoundTrips(0));
+    XERR_CHECK(RoundTrips(-1));
+    XERR_CHECK(RoundTrips(std::numeric_limits<int>::min()));
+    XERR_CHECK(RoundTrips(std::numeric_limits<int>::max()));
+    XERR_CHECK(RoundTrips(std::numeric_limits<std::int8_t>::min()));
+    XERR_CHECK(RoundTrips(std::numeric_limits<std::uint32_t>::max()));
+    XERR_CHECK(RoundTrips(true));
+    XERR_CHECK(RoundTrips(false));
+    XERR_CHECK(RoundTrips(color::RED));
+    XERR_CHECK(RoundTrips(color::BLUE));
+
+    const int Value = 5;
+    XERR_CHECK(RoundTrips(&Value));
+    XERR_CHECK(RoundTrips(static_cast<const int*>(nullptr)));
+
+    // Errors keep chaining through results
+    {
+        auto R = Doubled("21");
+        XERR_CHECK(R && *R == 42);
+
+        R = Doubled("");
+        XERR_CHECK(!R);
+        XERR_CHECK(R.getValueOr(-7) == -7);
+        XERR_CHECK(R.getError().getState<test_error>() == test_error::FAILURE);
+
+        std::string Chain;
+        R.getError().ForEachInChain([&](xerr E) { Chain += E.getMessage(); Chain += ';'; });
+        XERR_CHECK(Chain == "Empty;Doubled failed;");
+        R.getError().clear();
+    }
+
+    // Unpacked values live exactly as long as the result that holds them
+    {
+        {
+            xerr::result<tracked> A{ tracked{ 1 } };
+            xerr::result<tracked> B{ xerr::create<test_error::INVALID, "No value">() };
+            XERR_CHECK(tracked::s_nAlive == 1);
+
+            B = A;                                          // Error to value
+            XERR_CHECK(tracked::s_nAlive == 2 && B->m_Value == 1);
+
+            A = xerr::result<tracked>{ xerr::create<test_error::INVALID, "No value">() };
+            XERR_CHECK(tracked::s_nAlive == 1 && !A);       // Value to error
+
+            xerr::result<tracked> C{ std::move(B) };
+            XERR_CHECK(tracked::s_nAlive == 2 && C->m_Value == 1);
+
+            auto D = A;
+            XERR_CHECK(tracked::s_nAlive == 2 && D.getError().getMessage() == "No value");
+        }
+        XERR_CHECK(tracked::s_nAlive == 0);
+
+        xerr::result<std::string> S{ std::string(100, 'x') };
+        XERR_CHECK(S && S->size() == 100);
+        auto Moved = std::move(S).getValue();
+        XERR_CHECK(Moved.size() == 100);
+    }
+
+    return xerr_test::Result();
+}
@@ -0,0 +1,112 @@
+//-----------------------------------------------------------------------------------------
+// Segmented chain_pool
+//
+// Built with a 256-node pool grown in segments of 32. The pool starts empty, threads that
+// race to grow it all get whole chains, it stops growing at its capacity (where the
+// exhaustion policy takes over) and the nodes go back to the free list when chains are
+// cleared.
+//-----------------------------------------------------------------------------------------
+#include "xerr.h"
+#include "test_common.h"
+
+#include <atomic>
+#include <latch>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    enum class test_error : std::uint8_t
+    { OK
+    , FAILURE
+    , LINK
+    };
+
+    using pool = xerr_details::chain_pool;
+
+    //------------------------------------------------------------------------------------
+
+    xerr BuildChain(int nLinks) noexcept
+    {
+        xerr Err = xerr::create<test_error::LINK, "Root">();
+        for (int i = 1; i < nLinks; ++i) Err = xerr::create<test_error::LINK, "Link">(Err);
+        return Err;
+    }
+
+    //------------------------------------------------------------------------------------
+    // Links of the chain, 0 when it does not start with its root
+    int CountLinks(xerr Err) noexcept
+    {
+        int  n      = 0;
+        bool bRoot  = false;
+        Err.ForEachInChain([&](xerr E) { if (n++ == 0) bRoot = E.getMessage() == "Root"; });
+        return bRoot ? n : 0;
+    }
+
+    //------------------------------------------------------------------------------------
+
+    std::uint32_t nSegments(void) noexcept
+    {
+        return xerr::m_ChainPool.m_nSegments.load();
+    }
+}
+
+//-----------------------------------------------------------------------------------------
+
+int main(void)
+{
+    static_assert(pool::segmented_v && pool::capacity_v == 256 && pool::segment_size_v == 32);
+
+    // Nothing is allocated until the first chain, a lone error takes no node
+    XERR_CHECK(nSegments() == 0);
+    {
+        auto Err = BuildChain(1);
+        XERR_CHECK(CountLinks(Err) == 1);
+        XERR_CHECK(nSegments() == 0);
+        Err.clear();
+
+        Err = BuildChain(2);
+        XERR_CHECK(CountLinks(Err) == 2);
+        XERR_CHECK(nSegments() == 1);
+        Err.clear();
+    }
+
+    // Threads that run dry at the same time grow the pool once each segment
+    {
+        constexpr int threads_v = 8;
+        constexpr int links_v   = 24;
+
+        std::atomic<int>         nGood{ 0 };
+        std::latch               Start{ threads_v };
+        std::vector<std::thread> Threads;
+        for (int i = 0; i < threads_v; ++i) Threads.emplace_back([&]
+        {
+            Start.arrive_and_wait();
+            auto Err = BuildChain(links_v);
+            if (CountLinks(Err) == links_v) nGood.fetch_add(1);
+            Err.clear();
+        });
+        for (auto& Thread : Threads) Thread.join();
+
+        XERR_CHECK(nGood.load() == threads_v);
+        XERR_CHECK(nSegments() <= pool::capacity_v / pool::segment_size_v);
+        XERR_CHECK(xerr::m_ChainPool.m_TruncateCount.load() == 0);
+        for (std::uint32_t i = 0; i < nSegments(); ++i) XERR_CHECK(xerr::m_ChainPool.m_Segments[i].load() != nullptr);
+    }
+
+    // Past its capacity the pool stops growing and truncates
+    {
+        auto Err = BuildChain(300);
+        XERR_CHECK(nSegments() == pool::capacity_v / pool::segment_size_v);
+        XERR_CHECK(xerr::m_ChainPool.m_TruncateCount.load() == 300 - pool::capacity_v);
+        Err.clear();
+
+        Err = BuildChain(pool::capacity_v);
+        XERR_CHECK(CountLinks(Err) == int{ pool::capacity_v });
+        XERR_CHECK(xerr::m_ChainPool.m_TruncateCount.load() == 300 - pool::capacity_v);
+        Err.clear();
+    }
+
+    return xerr_test::Result();
+}
@@ -0,0 +1,74 @@
+//-----------------------------------------------------------------------------------------
+// xerr::Serialize / xerr::Deserialize
+//
+// A chain goes through a buffer and back. Sites this binary does not know keep the state
+// the sender recorded, and a known site recorded with another state rejects the buffer.
+//-----------------------------------------------------------------------------------------
+#include "xerr.h"
+#include "test_common.h"
+
+#include <array>
+
+namespace
+{
+    enum class test_error : std::uint8_t
+    { OK
+    , FAILURE
+    , NOT_FOUND
+    , TIMEOUT   = 7
+    };
+
+    //------------------------------------------------------------------------------------
+
+    void WriteLink(std::span<std::byte> Buffer, std::size_t iLink, std::uint64_t SiteID, std::uint8_t State) noexcept
+    {
+        auto* p = &Buffer[xerr::serial_header_size_v + iLink * xerr::serial_link_size_v];
+        for (int i = 0; i < 8; ++i) p[i] = static_cast<std::byte>(SiteID >> (8 * i));
+        p[8] = static_cast<std::byte>(State);
+    }
+}
+
+//-----------------------------------------------------------------------------------------
+
+int main(void)
+{
+    std::array<std::byte, 256> Buffer;
+
+    // Round trip
+    auto Err = xerr::create<test_error::NOT_FOUND, "File not found|Check the path">();
+    Err      = xerr::create<test_error::TIMEOUT,   "Load timed out">(Err);
+    const auto Size = Err.Serialize(Buffer);
+    XERR_CHECK(Size == xerr::serial_header_size_v + 2 * xerr::serial_link_size_v);
+
+    auto Back = xerr::Deserialize(std::span(Buffer).first(Size));
+    XERR_CHECK(Back == Err);
+    XERR_CHECK(Back.getState<test_error>() == test_error::TIMEOUT);
+    XERR_CHECK(Back.getMessage() == "Load timed out");
+
+    int nLinks = 0;     // Oldest first
+    Back.ForEachInChain([&](xerr Link)
+    {
+        if (nLinks++ == 0) XERR_CHECK(Link.getState<test_error>() == test_error::NOT_FOUND && Link.getHint() == "Check the path");
+    });
+    XERR_CHECK(nLinks == 2);
+
+    // A site this binary does not know keeps the recorded state
+    WriteLink(Buffer, 1, 0x1234567890abcdefull, static_cast<std::uint8_t>(test_error::TIMEOUT));
+    Back = xerr::Deserialize(std::span(Buffer).first(Size));
+    XERR_CHECK(Back.getMessage() == "Unknown remote error");
+    XERR_CHECK(Back.isState<xerr::default_states>());
+    XERR_CHECK(Back.getState<test_error>() == test_error::TIMEOUT);
+    XERR_CHECK(Back.hasChain());
+
+    // A known site with a state that is not its own is rejected
+    WriteLink(Buffer, 1, Err.getSiteID(), static_cast<std::uint8_t>(test_error::NOT_FOUND));
+    Back = xerr::Deserialize(std::span(Buffer).first(Size));
+    XERR_CHECK(Back.getMessage() == "Invalid serialized error");
+    XERR_CHECK(Back.getState<xerr::default_states>() == xerr::default_states::FAILURE);
+
+    // Truncated
+    Back = xerr::Deserialize(std::span(Buffer).first(Size - 1));
+    XERR_CHECK(Back.getMessage() == "Invalid serialized error");
+
+    return xerr_test::Result();
+}
@@ -0,0 +1,96 @@
+//-----------------------------------------------------------------------------------------
+// xerr_details::g_AsyncSink
+//
+// Records reach the callback with their arguments formatted on the drain side, a sink
+// without a drain thread is drained by hand, and stopping the sink while threads keep
+// failing loses nothing: every error is delivered once, by the sink or by the callback,
+// or counted as dropped.
+//-----------------------------------------------------------------------------------------
+#include "xerr_sink.h"
+#include "test_common.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    enum class test_error : std::uint8_t
+    { OK
+    , FAILURE
+    , IO
+    };
+
+    std::atomic<std::uint64_t>  g_nRecords      { 0 };
+    std::atomic<std::uint64_t>  g_nCallbacks    { 0 };
+    std::string                 g_LastMessage;
+
+    //------------------------------------------------------------------------------------
+
+    void OnRecord(const xerr_details::record&) noexcept
+    {
+        g_nRecords.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    //------------------------------------------------------------------------------------
+
+    void OnError(const char*, std::uint8_t, std::string_view Message, std::uint32_t, std::string_view) noexcept
+    {
+        g_nCallbacks.fetch_add(1, std::memory_order_relaxed);
+        g_LastMessage = Message;
+    }
+}
+
+//-----------------------------------------------------------------------------------------
+
+int main(void)
+{
+    auto& Sink = xerr_details::g_AsyncSink;
+    xerr::m_pCallback = OnError;
+
+    // Through the drain thread to xerr::m_pCallback, the arguments are formatted there
+    Sink.Start();
+    XERR_CHECK(Sink.isRunning());
+    (void)xerr::create<test_error::IO, "Cannot read {}">(xerr::args("a.bin"));
+    Sink.Stop();
+    XERR_CHECK(g_nCallbacks.load() == 1);
+    XERR_CHECK(g_LastMessage == "Cannot read a.bin");
+
+    // Without a drain thread the user drains
+    Sink.Start(OnRecord, std::chrono::milliseconds{ 0 });
+    for (int i = 0; i < 10; ++i) (void)xerr::create<test_error::IO, "Manual">();
+    XERR_CHECK(g_nRecords.load() == 0);
+    XERR_CHECK(Sink.Drain() == 10);
+    XERR_CHECK(g_nRecords.load() == 10);
+    Sink.Stop();
+
+    // Stop while threads keep failing: each error is delivered once, whoever delivers it
+    g_nRecords   = 0;
+    g_nCallbacks = 0;
+    std::atomic<bool>          bDone{ false };
+    std::atomic<std::uint64_t> nCreated{ 0 };
+    std::vector<std::thread>   Threads;
+    for (int i = 0; i < 4; ++i) Threads.emplace_back([&]
+    {
+        while (bDone.load(std::memory_order_relaxed) == false)
+        {
+            (void)xerr::create<test_error::FAILURE, "Busy">();
+            nCreated.fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+
+    for (int i = 0; i < 50; ++i)
+    {
+        Sink.Start(OnRecord, std::chrono::milliseconds{ 1 });
+        std::this_thread::yield();
+        Sink.Stop();
+    }
+
+    bDone = true;
+    for (auto& Thread : Threads) Thread.join();
+    XERR_CHECK(g_nRecords.load() + g_nCallbacks.load() + Sink.m_DropCount.load() == nCreated.load());
+
+    xerr::m_pCallback = nullptr;
+    return xerr_test::Result();
+}
@@ -0,0 +1,103 @@
+//-----------------------------------------------------------------------------------------
+// xerr_details::g_SiteStats
+//
+// Built with XERR_SITE_STATS=1 and only two site slots: exact totals from many threads for
+// the sites with a slot and for the one past them, counters of dead threads reused by new
+// ones, and TopN over the totals and over a window.
+//-----------------------------------------------------------------------------------------
+#include "xerr.h"
+#include "test_common.h"
+
+#include <array>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    enum class test_error : std::uint8_t
+    { OK
+    , FAILURE
+    , IO
+    };
+
+    void Busy    (int Count) noexcept { for (int i = 0; i < Count; ++i) (void)xerr::create<test_error::FAILURE, "Busy">(); }
+    void Read    (int Count) noexcept { for (int i = 0; i < Count; ++i) (void)xerr::create<test_error::IO, "Read">(); }
+    void Overflow(int Count) noexcept { for (int i = 0; i < Count; ++i) (void)xerr::create<test_error::IO, "Overflow">(); }
+
+    //------------------------------------------------------------------------------------
+
+    std::uint64_t CountOf(std::string_view Message) noexcept
+    {
+        std::uint64_t Count = 0;
+        xerr_details::g_SiteStats.ForEach([&](const xerr_details::site_stats& Site)
+        {
+            if (xerr{ Site.m_pMessage }.getMessage() == Message) Count = Site.getCount();
+        });
+        return Count;
+    }
+
+    //------------------------------------------------------------------------------------
+
+    std::size_t nCounters(void) noexcept
+    {
+        std::size_t n = 0;
+        for (auto* p = xerr_details::g_SiteStats.m_pCounters.load(); p; p = p->m_pNext) ++n;
+        return n;
+    }
+
+    //------------------------------------------------------------------------------------
+
+    void RunThreads(int nThreads) noexcept
+    {
+        std::vector<std::thread> Threads;
+        for (int i = 0; i < nThreads; ++i) Threads.emplace_back([] { Busy(1000); Read(10); Overflow(100); });
+        for (auto& Thread : Threads) Thread.join();
+    }
+}
+
+//-----------------------------------------------------------------------------------------
+
+int main(void)
+{
+    static_assert(xerr_details::site_stats::slots_v == 2);
+
+    // The first two sites get a slot, the third one uses the shared counter
+    Busy(5);
+    Read(3);
+    Overflow(1);
+    XERR_CHECK(CountOf("Busy") == 5);
+    XERR_CHECK(CountOf("Read") == 3);
+    XERR_CHECK(CountOf("Overflow") == 1);
+    XERR_CHECK(nCounters() == 1);
+
+    // Exact totals from many threads
+    RunThreads(8);
+    XERR_CHECK(CountOf("Busy") == 5 + 8 * 1000);
+    XERR_CHECK(CountOf("Read") == 3 + 8 * 10);
+    XERR_CHECK(CountOf("Overflow") == 1 + 8 * 100);
+
+    // New threads take the counters the dead ones left, their counts stay
+    const auto nBefore = nCounters();
+    XERR_CHECK(nBefore >= 2 && nBefore <= 9);
+    RunThreads(8);
+    XERR_CHECK(nCounters() == nBefore);
+    XERR_CHECK(CountOf("Busy") == 5 + 16 * 1000);
+
+    // Ranked by totals
+    std::array<xerr_details::site_report, 2> Top;
+    XERR_CHECK(xerr_details::g_SiteStats.TopN(Top) == 2);
+    XERR_CHECK(xerr{ Top[0].m_pMessage }.getMessage() == "Busy");
+    XERR_CHECK(xerr{ Top[1].m_pMessage }.getMessage() == "Overflow");
+    XERR_CHECK(Top[0].m_WindowCount == Top[0].m_Count);
+
+    // Ranked by what happened since the oldest sample in the window
+    xerr_details::g_SiteStats.Sample();
+    Read(50);
+    Overflow(20);
+    XERR_CHECK(xerr_details::g_SiteStats.TopN(Top, std::chrono::seconds{ 60 }) == 2);
+    XERR_CHECK(xerr{ Top[0].m_pMessage }.getMessage() == "Read");
+    XERR_CHECK(Top[0].m_WindowCount == 50);
+    XERR_CHECK(Top[1].m_WindowCount == 20);
+
+    return xerr_test::Result();
+}
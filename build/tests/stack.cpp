@@ -0,0 +1,97 @@
+//-----------------------------------------------------------------------------------------
+// xerr::getStack and xerr::Symbolize
+//
+// Built with XERR_STACK_DEPTH=16, XERR_STACK_SLOTS=4, frame pointers and exported symbols.
+// The stack of an error goes through the functions that created it, innermost first, it is
+// only known to the thread that created the error and until four newer errors replaced it.
+//-----------------------------------------------------------------------------------------
+#include "xerr.h"
+#include "test_common.h"
+
+#include <string_view>
+#include <thread>
+
+enum class test_error : std::uint8_t
+{ OK
+, FAILURE
+, IO
+};
+
+// Not static, dladdr only names exported functions. The counter keeps the calls out of tail position
+volatile int g_nCalls = 0;
+
+[[gnu::noinline]] xerr StackInner(void) noexcept
+{
+    auto Err = xerr::create<test_error::IO, "Cannot read">();
+    g_nCalls = g_nCalls + 1;
+    return Err;
+}
+
+[[gnu::noinline]] xerr StackOuter(void) noexcept
+{
+    auto Err = StackInner();
+    g_nCalls = g_nCalls + 1;
+    return Err;
+}
+
+namespace
+{
+    // Position of the first frame inside Function, -1 when none
+    int FindFrame(std::span<void* const> Stack, std::string_view Function) noexcept
+    {
+        char Buffer[512];
+        for (std::size_t i = 0; i < Stack.size(); ++i)
+            if (xerr::Symbolize(Stack[i], Buffer).find(Function) != std::string_view::npos) return static_cast<int>(i);
+        return -1;
+    }
+}
+
+//-----------------------------------------------------------------------------------------
+
+int main(void)
+{
+    static_assert(xerr_details::stack_pool::depth_v == 16 && xerr_details::stack_pool::slots_v == 4);
+
+    auto Err   = StackOuter();
+    auto Stack = Err.getStack();
+    XERR_CHECK(Stack.empty() == false && Stack.size() <= 16);
+
+#if __has_include(<dlfcn.h>)
+    // Innermost first
+    const auto iInner = FindFrame(Stack, "StackInner");
+    const auto iOuter = FindFrame(Stack, "StackOuter");
+    XERR_CHECK(iInner >= 0);
+    XERR_CHECK(iOuter > iInner);
+    XERR_CHECK(FindFrame(Stack, "main") > iOuter);
+#endif
+
+    // Symbolize always fits the buffer
+    {
+        char Small[8];
+        const auto Text = xerr::Symbolize(Stack[0], Small);
+        XERR_CHECK(Text.size() == 7 && Small[7] == 0);
+        XERR_CHECK(xerr::Symbolize(Stack[0], std::span<char>{}).empty());
+    }
+
+    // Other threads do not have it
+    {
+        bool bEmpty = false;
+        std::thread([&] { bEmpty = Err.getStack().empty(); }).join();
+        XERR_CHECK(bEmpty);
+    }
+
+    // Three newer errors keep it, the fourth takes its slot
+    {
+        for (int i = 0; i < 3; ++i) (void)xerr::create<test_error::FAILURE, "Other">();
+        XERR_CHECK(Err.getStack().size() == Stack.size());
+
+        (void)xerr::create<test_error::FAILURE, "Other">();
+        XERR_CHECK(Err.getStack().empty());
+    }
+
+    // An empty error has no stack
+    XERR_CHECK(xerr{}.getStack().empty());
+
+    Err.clear();
+    return xerr_test::Result();
+}
@@ -0,0 +1,48 @@
+//-----------------------------------------------------------------------------------------
+// State name tables
+//
+// Every reported state of an enum has its name in the table, states past a long gap get
+// theirs from the catalog, and states filtered by xerr::report_policy have no name at all.
+// The test "state_names_filtered" also checks the name of the filtered state is not in the
+// executable, which is why this test is built without debug information.
+//-----------------------------------------------------------------------------------------
+#include "xerr.h"
+#include "test_common.h"
+
+#include <string_view>
+
+namespace
+{
+    enum class test_error : std::uint8_t
+    { OK
+    , FAILURE
+    , SECRET_FILTERED_STATE
+    , SHOWN
+    , FAR       = 200
+    };
+}
+
+template<> struct xerr::report_policy<test_error>
+{
+    constexpr static bool isReported(test_error State) noexcept { return State != test_error::SECRET_FILTERED_STATE; }
+};
+
+//-----------------------------------------------------------------------------------------
+
+int main(void)
+{
+    // The scan stops at the first block without enumerators, FAR is past it
+    static_assert(xerr_details::state_value_names_v<test_error>.size() == xerr_details::state_block_size_v);
+    static_assert(xerr_details::state_names<test_error>::count_v == static_cast<std::size_t>(test_error::SHOWN) + 1);
+
+    const auto Shown    = xerr::create<test_error::SHOWN,                 "Shown state">();
+    const auto Far      = xerr::create<test_error::FAR,                   "Far state">();
+    const auto Filtered = xerr::create<test_error::SECRET_FILTERED_STATE, "Filtered state">();
+
+    XERR_CHECK(Shown.getStateName().ends_with("test_error::SHOWN"));
+    XERR_CHECK(Far.getStateName().ends_with("test_error::FAR"));
+    XERR_CHECK(Filtered.getStateName().empty());
+    XERR_CHECK(Filtered.getState<test_error>() == test_error::SECRET_FILTERED_STATE);
+
+    return xerr_test::Result();
+}
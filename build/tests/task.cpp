@@ -0,0 +1,102 @@
+//-----------------------------------------------------------------------------------------
+// xerr::task
+//
+// Value and void tasks, errors short circuiting the awaiting tasks, and void tasks that
+// end with co_return; or by reaching the end of their body.
+//-----------------------------------------------------------------------------------------
+#include "xerr_task.h"
+#include "test_common.h"
+
+namespace
+{
+    enum class test_error : std::uint8_t
+    { OK
+    , FAILURE
+    , INVALID
+    };
+
+    //------------------------------------------------------------------------------------
+
+    xerr::task<int> getSize(int Size) noexcept
+    {
+        if (Size < 0) co_return xerr::create<test_error::INVALID, "Negative size">();
+        co_return Size;
+    }
+
+    //------------------------------------------------------------------------------------
+
+    xerr::task<> Check(int Size, int& nChecked) noexcept
+    {
+        const int Value = co_await getSize(Size);
+        if (Value > 100) co_await xerr::create<test_error::FAILURE, "Too big">();
+        ++nChecked;
+    }
+
+    //------------------------------------------------------------------------------------
+
+    xerr::task<> CheckEarly(int Size, int& nChecked) noexcept
+    {
+        if (Size == 0) co_return;
+        co_await Check(Size, nChecked);
+    }
+
+    //------------------------------------------------------------------------------------
+
+    xerr::task<int> Sum(int A, int B, int& nChecked) noexcept
+    {
+        co_await CheckEarly(A, nChecked);
+        co_await CheckEarly(B, nChecked);
+        co_return A + B;
+    }
+
+    //------------------------------------------------------------------------------------
+
+    template< typename T >
+    auto Run(xerr::task<T>&& Task) noexcept
+    {
+        Task.Start();
+        XERR_CHECK(Task.isDone());
+        return Task.getResult();
+    }
+}
+
+//-----------------------------------------------------------------------------------------
+
+int main(void)
+{
+    int nChecked = 0;
+
+    // Reaching the end of a void task
+    XERR_CHECK(!Run(Check(5, nChecked)));
+    XERR_CHECK(nChecked == 1);
+
+    // co_return; in a void task
+    XERR_CHECK(!Run(CheckEarly(0, nChecked)));
+    XERR_CHECK(nChecked == 1);
+
+    // A void task failing with co_await
+    auto Err = Run(Check(500, nChecked));
+    XERR_CHECK(Err.getState<test_error>() == test_error::FAILURE);
+    XERR_CHECK(nChecked == 1);
+
+    // Errors of awaited tasks short circuit every awaiting task, void or not
+    auto Result = Run(Sum(1, -1, nChecked));
+    XERR_CHECK(!Result.hasValue());
+    XERR_CHECK(Result.getError().getState<test_error>() == test_error::INVALID);
+    XERR_CHECK(nChecked == 2);
+
+    Result = Run(Sum(1, 2, nChecked));
+    XERR_CHECK(Result.hasValue() && Result.getValue() == 3);
+    XERR_CHECK(nChecked == 4);
+
+    // AsResult gives the error of a void task instead of returning it
+    auto Outer = [](int& nChecked) noexcept -> xerr::task<int>
+    {
+        auto Err = co_await Check(1000, nChecked).AsResult();
+        co_return Err ? -1 : 1;
+    };
+    Result = Run(Outer(nChecked));
+    XERR_CHECK(Result.hasValue() && Result.getValue() == -1);
+
+    return xerr_test::Result();
+}
@@ -0,0 +1,33 @@
+#ifndef XERR_TEST_COMMON_H
+#define XERR_TEST_COMMON_H
+#pragma once
+
+//-----------------------------------------------------------------------------------------
+// Minimal checks shared by the xerr tests. A failed check prints where it failed and the
+// test keeps going, main returns xerr_test::Result() so ctest sees the failure.
+//-----------------------------------------------------------------------------------------
+#include <cstdio>
+
+namespace xerr_test
+{
+    inline int g_nFailures = 0;
+
+    inline bool Check(bool bOk, const char* pExpr, const char* pFile, int Line) noexcept
+    {
+        if (bOk) return true;
+        std::printf("%s(%d): check failed: %s\n", pFile, Line, pExpr);
+        ++g_nFailures;
+        return false;
+    }
+
+    inline int Result(void) noexcept
+    {
+        if (g_nFailures) std::printf("%d check(s) failed\n", g_nFailures);
+        else             std::printf("OK\n");
+        return g_nFailures ? 1 : 0;
+    }
+}
+
+#define XERR_CHECK(EXPR) xerr_test::Check(!!(EXPR), #EXPR, __FILE__, __LINE__)
+
+#endif
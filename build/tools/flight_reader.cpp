@@ -0,0 +1,168 @@
+// Prints the errors kept in a flight recorder file (see xerr_details::g_FlightRecorder), oldest first per thread:
+//
+//      xerr_flight_reader crash.xefr
+//
+// Only the layout structs of xerr.h are used, the file has its own catalog so the binary that
+// wrote it is not needed.
+#include "xerr_flight_recorder.h"
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using recorder = xerr_details::flight_recorder;
+
+struct site
+{
+    std::string     m_StateName;
+    std::string     m_Message;
+    std::string     m_Hint;
+};
+
+//-----------------------------------------------------------------------------------------
+
+static bool ReadFile(const char* pPath, std::vector<std::byte>& Data)
+{
+    std::FILE* pFile = std::fopen(pPath, "rb");
+    if (pFile == nullptr) return false;
+
+    std::byte Buffer[1 << 16];
+    for (std::size_t n; (n = std::fread(Buffer, 1, sizeof(Buffer), pFile)) > 0; )
+        Data.insert(Data.end(), Buffer, Buffer + n);
+
+    std::fclose(pFile);
+    return true;
+}
+
+//-----------------------------------------------------------------------------------------
+
+template< typename T >
+static T Load(const std::vector<std::byte>& Data, std::size_t Offset)
+{
+    T Value;
+    std::memcpy(&Value, &Data[Offset], sizeof(T));
+    return Value;
+}
+
+//-----------------------------------------------------------------------------------------
+
+static std::unordered_map<std::uint64_t, site> LoadCatalog(const std::vector<std::byte>& Data, const recorder::file_header& Header)
+{
+    std::unordered_map<std::uint64_t, site> Catalog;
+
+    std::size_t       Offset = Header.m_CatalogOffset;
+    const std::size_t End    = Header.m_CatalogOffset + Header.m_CatalogSize;
+    for (std::uint32_t i = 0; i < Header.m_nCatalog && Offset + sizeof(recorder::catalog_header) <= End; ++i)
+    {
+        const auto Entry = Load<recorder::catalog_header>(Data, Offset);
+        Offset += sizeof(Entry);
+        if (Offset + Entry.m_StateNameLength + Entry.m_MessageLength > End) break;
+
+        const auto* pText = reinterpret_cast<const char*>(&Data[Offset]);
+        std::string_view Message{ pText + Entry.m_StateNameLength, Entry.m_MessageLength };
+        const auto       iHint = Message.find('|');
+
+        Catalog[Entry.m_SiteID] = site
+        { std::string{ pText, Entry.m_StateNameLength }
+        , std::string{ Message.substr(0, iHint) }
+        , iHint == std::string_view::npos ? std::string{} : std::string{ Message.substr(iHint + 1) }
+        };
+        Offset += Entry.m_StateNameLength + Entry.m_MessageLength;
+    }
+
+    return Catalog;
+}
+
+//-----------------------------------------------------------------------------------------
+
+static void PrintRecord(const recorder::record& Record, std::uint64_t StartTime, const std::unordered_map<std::uint64_t, site>& Catalog)
+{
+    const double Seconds = static_cast<double>(static_cast<std::int64_t>(Record.m_Timestamp - StartTime)) / 1e9;
+
+    if (auto It = Catalog.find(Record.m_SiteID); It != Catalog.end())
+    {
+        const auto& Site = It->second;
+        std::printf("  %+12.6fs  %s(%u)  \"%s\"", Seconds, Site.m_StateName.empty() ? "?" : Site.m_StateName.c_str(), Record.m_State, Site.m_Message.c_str());
+        if (Site.m_Hint.empty() == false) std::printf(" hint \"%s\"", Site.m_Hint.c_str());
+    }
+    else
+    {
+        std::printf("  %+12.6fs  state %u  site %016" PRIx64, Seconds, Record.m_State, Record.m_SiteID);
+    }
+
+    if (Record.m_Line) std::printf("  line %u", Record.m_Line);
+    std::printf("\n");
+
+    for (std::uint8_t i = 0; i < Record.m_nLinks && i < recorder::max_links_v; ++i)
+    {
+        if (auto It = Catalog.find(Record.m_Links[i]); It != Catalog.end()) std::printf("                 caused by %s \"%s\"\n", It->second.m_StateName.c_str(), It->second.m_Message.c_str());
+        else                                                                std::printf("                 caused by site %016" PRIx64 "\n", Record.m_Links[i]);
+    }
+}
+
+//-----------------------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+    if (argc != 2)
+    {
+        std::fprintf(stderr, "usage: %s <flight recorder file>\n", argv[0]);
+        return 2;
+    }
+
+    std::vector<std::byte> Data;
+    if (ReadFile(argv[1], Data) == false)
+    {
+        std::fprintf(stderr, "error: can not read %s\n", argv[1]);
+        return 1;
+    }
+
+    if (Data.size() < sizeof(recorder::file_header))
+    {
+        std::fprintf(stderr, "error: %s is too small\n", argv[1]);
+        return 1;
+    }
+
+    const auto Header = Load<recorder::file_header>(Data, 0);
+    if (Header.m_Magic != recorder::magic_v || Header.m_Version != recorder::version_v || Header.m_RecordSize != sizeof(recorder::record))
+    {
+        std::fprintf(stderr, "error: %s is not a version %u flight recorder file\n", argv[1], recorder::version_v);
+        return 1;
+    }
+
+    const std::size_t RingStride = sizeof(recorder::ring_header) + std::size_t{ Header.m_RecordsPerThread } * sizeof(recorder::record);
+    if (Header.m_RecordsPerThread == 0 || Header.m_RingsOffset + std::size_t{ Header.m_MaxThreads } * RingStride > Header.m_CatalogOffset || Header.m_CatalogOffset + Header.m_CatalogSize > Data.size())
+    {
+        std::fprintf(stderr, "error: %s is truncated\n", argv[1]);
+        return 1;
+    }
+
+    const auto Catalog  = LoadCatalog(Data, Header);
+    const auto nThreads = std::min(Header.m_nThreads, Header.m_MaxThreads);
+
+    std::printf("%u threads, %u sites in the catalog\n", nThreads, Header.m_nCatalog);
+    if (Header.m_nThreads > Header.m_MaxThreads) std::printf("%u threads were not recorded (out of rings)\n", Header.m_nThreads - Header.m_MaxThreads);
+
+    for (std::uint32_t t = 0; t < nThreads; ++t)
+    {
+        const std::size_t RingOffset = Header.m_RingsOffset + t * RingStride;
+        const auto        Ring       = Load<recorder::ring_header>(Data, RingOffset);
+        const auto        First      = Ring.m_Head > Header.m_RecordsPerThread ? Ring.m_Head - Header.m_RecordsPerThread : 0;
+
+        std::printf("\nthread %016" PRIx64 ", %" PRIu64 " errors\n", Ring.m_ThreadID, Ring.m_Head);
+        if (First) std::printf("  (%" PRIu64 " older errors were overwritten)\n", First);
+
+        // Also look at the slot past the head, the thread may have died before it moved the head
+        for (std::uint64_t i = First; i <= Ring.m_Head; ++i)
+        {
+            const auto Record = Load<recorder::record>(Data, RingOffset + sizeof(recorder::ring_header) + (i % Header.m_RecordsPerThread) * sizeof(recorder::record));
+            if (Record.m_Sequence == static_cast<std::uint32_t>(i + 1)) PrintRecord(Record, Header.m_StartTime, Catalog);
+            else if (i < Ring.m_Head)                                   std::printf("  (record %" PRIu64 " was being written)\n", i);
+        }
+    }
+
+    return 0;
+}
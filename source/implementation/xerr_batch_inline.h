@@ -0,0 +1,231 @@
+#include <algorithm>
+#include <cassert>
+#include <new>
+#include <utility>
+
+namespace xerr_details
+{
+    //------------------------------------------------------------------------------------
+    // BATCH COLLECTOR
+    //------------------------------------------------------------------------------------
+
+    // Batch whose collector the thread used last, so a failure does not search the list
+    struct batch_cache
+    {
+        std::uint64_t               m_BatchID       = 0;
+        batch_collector*            m_pCollector    = nullptr;
+    };
+
+    thread_local inline batch_cache     g_BatchCache    = {};
+    inline std::atomic<std::uint64_t>   g_BatchID       { 0 };
+
+    //------------------------------------------------------------------------------------
+
+    inline batch_collector::~batch_collector(void) noexcept
+    {
+        for (auto* pChunk = m_pChunk; pChunk; ) delete std::exchange(pChunk, pChunk->m_pNext);
+    }
+
+    //------------------------------------------------------------------------------------
+    // Only the owner thread calls it. Returns false when a chunk can not be allocated
+    inline bool batch_collector::Add(std::size_t Index, xerr Error) noexcept
+    {
+        if (m_pChunk == nullptr || m_pChunk->m_Count == chunk_size_v)
+        {
+            auto* pChunk = new (std::nothrow) chunk;
+            if (pChunk == nullptr) return false;
+            pChunk->m_pNext = m_pChunk;
+            m_pChunk        = pChunk;
+        }
+
+        m_pChunk->m_Failures[m_pChunk->m_Count++] = { Index, Error };
+        ++m_Count;
+        return true;
+    }
+}
+
+//------------------------------------------------------------------------------------
+// BATCH
+//------------------------------------------------------------------------------------
+
+inline
+xerr::batch::batch(std::size_t Count, mode Mode) noexcept
+    : m_pBitmap { new (std::nothrow) std::atomic<std::uint64_t>[(Count + 63) / 64]{} }
+    , m_Count   { Count }
+    , m_Mode    { Mode }
+    , m_ID      { xerr_details::g_BatchID.fetch_add(1, std::memory_order_relaxed) + 1 }
+{
+}
+
+//------------------------------------------------------------------------------------
+
+inline
+xerr::batch::~batch(void) noexcept
+{
+    clear();
+    delete[] m_pBitmap;
+}
+
+//------------------------------------------------------------------------------------
+// Collector of the calling thread, created the first time the thread records a failure
+inline
+xerr_details::batch_collector* xerr::batch::getCollector(void) noexcept
+{
+    auto& Cache = xerr_details::g_BatchCache;
+    if (Cache.m_BatchID == m_ID) return Cache.m_pCollector;
+
+    // The thread may have used another batch in between
+    const auto ThreadID   = std::this_thread::get_id();
+    auto*      pCollector = m_pCollectors.load(std::memory_order_acquire);
+    while (pCollector && pCollector->m_ThreadID != ThreadID) pCollector = pCollector->m_pNext;
+
+    if (pCollector == nullptr)
+    {
+        pCollector = new (std::nothrow) xerr_details::batch_collector;
+        if (pCollector == nullptr) return nullptr;
+
+        pCollector->m_ThreadID = ThreadID;
+        pCollector->m_pNext    = m_pCollectors.load(std::memory_order_relaxed);
+        while (!m_pCollectors.compare_exchange_weak(pCollector->m_pNext, pCollector, std::memory_order_release, std::memory_order_relaxed)) {}
+    }
+
+    Cache = { m_ID, pCollector };
+    return pCollector;
+}
+
+//------------------------------------------------------------------------------------
+// Takes the thread chain of the error: the first failure keeps it, the others release it
+inline
+void xerr::batch::Record(std::size_t Index, xerr Error) noexcept
+{
+    if (!Error) return;
+    assert(Index < m_Count);
+
+    if (m_pBitmap) m_pBitmap[Index / 64].fetch_or(std::uint64_t{ 1 } << (Index % 64), std::memory_order_relaxed);
+
+    owned Chain{ Error };
+
+    if (auto Expected = npos_v; m_FirstIndex.load(std::memory_order_relaxed) == npos_v && m_FirstIndex.compare_exchange_strong(Expected, Index, std::memory_order_acq_rel))
+    {
+        m_First = std::move(Chain);
+        if (m_Mode == mode::FIRST_ERROR) Cancel();
+    }
+
+    if (m_Mode == mode::ALL_ERRORS)
+    {
+        auto* pCollector = getCollector();
+        if (pCollector == nullptr || pCollector->Add(Index, Error) == false) m_LostCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+//------------------------------------------------------------------------------------
+// Returns true when the element ran without an error
+template< typename T_CALLBACK >
+inline
+bool xerr::batch::Invoke(std::size_t Index, T_CALLBACK&& Callback) noexcept requires std::is_invocable_r_v<xerr, T_CALLBACK>
+{
+    if (isCancelled()) return false;
+
+    const xerr Error = std::forward<T_CALLBACK>(Callback)();
+    if (!Error) return true;
+
+    Record(Index, Error);
+    return false;
+}
+
+//------------------------------------------------------------------------------------
+
+inline
+bool xerr::batch::isFailed(std::size_t Index) const noexcept
+{
+    if (Index >= m_Count) return false;
+    if (m_pBitmap) return (m_pBitmap[Index / 64].load(std::memory_order_relaxed) >> (Index % 64)) & 1;
+
+    if (m_FirstIndex.load(std::memory_order_acquire) == Index) return true;
+    bool bFound = false;
+    ForEach([&](std::size_t i, xerr) { bFound |= i == Index; });
+    return bFound;
+}
+
+//------------------------------------------------------------------------------------
+// Elements that failed, including the ones FIRST_ERROR did not record
+inline
+std::size_t xerr::batch::getFailedCount(void) const noexcept
+{
+    std::size_t Count = 0;
+    if (m_pBitmap)
+    {
+        for (std::size_t i = 0; i < (m_Count + 63) / 64; ++i) Count += std::popcount(m_pBitmap[i].load(std::memory_order_relaxed));
+        return Count;
+    }
+
+    for (auto* pCollector = m_pCollectors.load(std::memory_order_acquire); pCollector; pCollector = pCollector->m_pNext) Count += pCollector->m_Count;
+    if (m_Mode == mode::FIRST_ERROR && *this) ++Count;
+    return Count + m_LostCount.load(std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------------
+// Visits the recorded failures grouped by thread, in no particular order
+template< typename T_CALLBACK >
+inline
+void xerr::batch::ForEach(T_CALLBACK&& Callback) const noexcept requires std::invocable<T_CALLBACK, std::size_t, xerr>
+{
+    if (m_Mode == mode::FIRST_ERROR)
+    {
+        if (*this) Callback(getFirstIndex(), m_First.get());
+        return;
+    }
+
+    for (auto* pCollector = m_pCollectors.load(std::memory_order_acquire); pCollector; pCollector = pCollector->m_pNext)
+        for (auto* pChunk = pCollector->m_pChunk; pChunk; pChunk = pChunk->m_pNext)
+            for (std::uint32_t i = 0; i < pChunk->m_Count; ++i)
+                Callback(pChunk->m_Failures[i].m_Index, pChunk->m_Failures[i].m_Error);
+}
+
+//------------------------------------------------------------------------------------
+// Writes the failures with the lowest indices into Out, sorted by index. Returns how many
+inline
+std::size_t xerr::batch::Collect(std::span<xerr_details::batch_failure> Out) const noexcept
+{
+    if (Out.empty()) return 0;
+
+    // Max heap on the index, so a lower index can replace the highest one kept
+    constexpr auto Less = [](const xerr_details::batch_failure& A, const xerr_details::batch_failure& B) noexcept { return A.m_Index < B.m_Index; };
+
+    std::size_t n = 0;
+    ForEach([&](std::size_t Index, xerr Error)
+    {
+        if (n < Out.size())
+        {
+            Out[n++] = { Index, Error };
+            std::push_heap(Out.begin(), Out.begin() + n, Less);
+        }
+        else if (Index < Out.front().m_Index)
+        {
+            std::pop_heap(Out.begin(), Out.end(), Less);
+            Out.back() = { Index, Error };
+            std::push_heap(Out.begin(), Out.end(), Less);
+        }
+    });
+
+    std::sort_heap(Out.begin(), Out.begin() + n, Less);
+    return n;
+}
+
+//------------------------------------------------------------------------------------
+// Gets the batch ready for another loop. No thread can be using it
+inline
+void xerr::batch::clear(void) noexcept
+{
+    for (auto* pCollector = m_pCollectors.exchange(nullptr, std::memory_order_acquire); pCollector; )
+        delete std::exchange(pCollector, pCollector->m_pNext);
+
+    if (m_pBitmap) for (std::size_t i = 0; i < (m_Count + 63) / 64; ++i) m_pBitmap[i].store(0, std::memory_order_relaxed);
+
+    // The collectors cached by the threads are gone, a new ID makes the caches miss
+    m_ID = xerr_details::g_BatchID.fetch_add(1, std::memory_order_relaxed) + 1;
+    m_First.clear();
+    m_FirstIndex.store(npos_v, std::memory_order_relaxed);
+    m_LostCount.store(0, std::memory_order_relaxed);
+    m_bCancelled.store(false, std::memory_order_relaxed);
+}
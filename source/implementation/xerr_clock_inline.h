@@ -0,0 +1,28 @@
+#ifndef XERROR_CLOCK_INLINE_H
+#define XERROR_CLOCK_INLINE_H
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+//-----------------------------------------------------------------------------------------
+// Clocks of the opt-in subsystems (sink, site stats, report limits, flight recorder), kept out
+// of xerr.h so that only the translation units that use one of them pay for <chrono>
+//-----------------------------------------------------------------------------------------
+namespace xerr_details
+{
+    // Nanoseconds of the steady clock, for intervals
+    inline std::uint64_t SteadyNow(void) noexcept
+    {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    //------------------------------------------------------------------------------------
+    // Nanoseconds since the epoch, for the timestamps of records
+    inline std::uint64_t SystemNow(void) noexcept
+    {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+    }
+}
+
+#endif
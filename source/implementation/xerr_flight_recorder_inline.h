@@ -0,0 +1,202 @@
+#include "xerr_clock_inline.h"
+
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <thread>
+
+#if XERR_FLIGHT_RECORDER && __has_include(<sys/mman.h>)
+    #include <sys/mman.h>
+#endif
+
+namespace xerr_details
+{
+    //------------------------------------------------------------------------------------
+    // FLIGHT RECORDER
+    //------------------------------------------------------------------------------------
+
+    struct flight_ring_cache
+    {
+        flight_recorder::ring_header*   m_pRing         = nullptr;
+        std::uint32_t                   m_Generation    = 0;
+    };
+
+    thread_local inline flight_ring_cache g_FlightRing = {};
+
+    //------------------------------------------------------------------------------------
+    // Maps the file and writes the header and the catalog. Sites that register later (dlopen)
+    // are recorded by ID only. Returns false when the recorder is already open: threads may be
+    // writing to the current file, only Close can take it away. POSIX only, returns false
+    // elsewhere or when XERR_FLIGHT_RECORDER is 0
+    inline bool flight_recorder::Open(const char* pPath, std::uint32_t MaxThreads, std::uint32_t RecordsPerThread) noexcept
+    {
+#if XERR_FLIGHT_RECORDER && __has_include(<sys/mman.h>)
+        if (pPath == nullptr || MaxThreads == 0 || RecordsPerThread == 0) return false;
+
+        bool bOpen = false;
+        if (m_bOpen.compare_exchange_strong(bOpen, true, std::memory_order_acquire) == false) return false;
+
+        auto getMessageLength = [](const catalog_entry& Entry) noexcept
+        {
+            const auto& Info = GetInfo(Entry.m_pMessage);
+            return static_cast<std::size_t>(Info.m_HintOffset + Info.m_HintLength);
+        };
+
+        std::size_t CatalogSize = 0;
+        xerr::m_Catalog.ForEach([&](const catalog_entry& Entry)
+        {
+            CatalogSize += sizeof(catalog_header) + std::strlen(Entry.m_pStateName) + getMessageLength(Entry);
+        });
+
+        const std::size_t RingStride    = sizeof(ring_header) + std::size_t{ RecordsPerThread } * sizeof(record);
+        const std::size_t RingsOffset   = sizeof(file_header);
+        const std::size_t CatalogOffset = RingsOffset + std::size_t{ MaxThreads } * RingStride;
+        const std::size_t Size          = CatalogOffset + CatalogSize;
+
+        // Stdio keeps open/close of <fcntl.h> out of the user's global namespace
+        std::FILE* pFile = std::fopen(pPath, "w+b");
+        if (pFile == nullptr)
+        {
+            m_bOpen.store(false, std::memory_order_release);
+            return false;
+        }
+
+        // The file is zero filled, empty rings and records need no initialization
+        const bool bSized = std::fseek(pFile, static_cast<long>(Size - 1), SEEK_SET) == 0 && std::fputc(0, pFile) == 0 && std::fflush(pFile) == 0;
+        void*      pMap   = bSized ? ::mmap(nullptr, Size, PROT_READ | PROT_WRITE, MAP_SHARED, ::fileno(pFile), 0) : MAP_FAILED;
+        std::fclose(pFile);
+        if (pMap == MAP_FAILED)
+        {
+            m_bOpen.store(false, std::memory_order_release);
+            return false;
+        }
+
+        auto* pBase = static_cast<std::byte*>(pMap);
+
+        // Catalog, the list may have grown since it was measured
+        std::size_t Offset   = CatalogOffset;
+        std::uint32_t nCatalog = 0;
+        xerr::m_Catalog.ForEach([&](const catalog_entry& Entry)
+        {
+            const auto NameLength    = std::min<std::size_t>(std::strlen(Entry.m_pStateName), 0xffff);
+            const auto MessageLength = getMessageLength(Entry);
+            if (Offset + sizeof(catalog_header) + NameLength + MessageLength > Size) return;
+
+            const catalog_header Header{ Entry.m_ID, static_cast<std::uint16_t>(NameLength), static_cast<std::uint16_t>(MessageLength), static_cast<std::uint8_t>(Entry.m_pMessage[-1]), {} };
+            std::memcpy(&pBase[Offset], &Header, sizeof(Header));
+            std::memcpy(&pBase[Offset + sizeof(Header)], Entry.m_pStateName, NameLength);
+            std::memcpy(&pBase[Offset + sizeof(Header) + NameLength], Entry.m_pMessage, MessageLength);
+            Offset += sizeof(Header) + NameLength + MessageLength;
+            ++nCatalog;
+        });
+
+        auto& Header = *reinterpret_cast<file_header*>(pBase);
+        Header.m_Magic              = magic_v;
+        Header.m_Version            = version_v;
+        Header.m_RecordSize         = static_cast<std::uint16_t>(sizeof(record));
+        Header.m_MaxThreads         = MaxThreads;
+        Header.m_RecordsPerThread   = RecordsPerThread;
+        Header.m_RingsOffset        = RingsOffset;
+        Header.m_CatalogOffset      = CatalogOffset;
+        Header.m_CatalogSize        = Offset - CatalogOffset;
+        Header.m_StartTime          = SystemNow();
+        Header.m_nCatalog           = nCatalog;
+
+        m_Size              = Size;
+        m_RingStride        = RingStride;
+        m_RecordsPerThread  = RecordsPerThread;
+        m_Generation.fetch_add(1, std::memory_order_relaxed);
+        m_pBase.store(pBase, std::memory_order_release);
+        return true;
+#else
+        (void)pPath; (void)MaxThreads; (void)RecordsPerThread;
+        return false;
+#endif
+    }
+
+    //------------------------------------------------------------------------------------
+    // Only call it when no thread can be creating errors. Leaving the recorder open until
+    // the process ends is fine, the OS writes the pages back
+    inline void flight_recorder::Close(void) noexcept
+    {
+#if XERR_FLIGHT_RECORDER && __has_include(<sys/mman.h>)
+        if (auto* pBase = m_pBase.exchange(nullptr, std::memory_order_acq_rel); pBase)
+        {
+            ::msync(pBase, m_Size, MS_SYNC);
+            ::munmap(pBase, m_Size);
+            m_bOpen.store(false, std::memory_order_release);
+        }
+#endif
+    }
+
+    //------------------------------------------------------------------------------------
+
+    inline bool flight_recorder::isOpen(void) const noexcept
+    {
+        return m_pBase.load(std::memory_order_relaxed) != nullptr;
+    }
+
+    //------------------------------------------------------------------------------------
+    // Ring of the calling thread, taken the first time the thread records something
+    inline flight_recorder::ring_header* flight_recorder::getRing(void) noexcept
+    {
+        auto* pBase = m_pBase.load(std::memory_order_acquire);
+        if (pBase == nullptr) return nullptr;
+
+        auto&      Cache      = g_FlightRing;
+        const auto Generation = m_Generation.load(std::memory_order_relaxed);
+        if (Cache.m_Generation == Generation) return Cache.m_pRing;
+
+        // Threads past m_MaxThreads are not recorded
+        auto&      Header = *reinterpret_cast<file_header*>(pBase);
+        const auto iRing  = std::atomic_ref<std::uint32_t>(Header.m_nThreads).fetch_add(1, std::memory_order_relaxed);
+
+        Cache.m_Generation = Generation;
+        Cache.m_pRing      = nullptr;
+        if (iRing >= Header.m_MaxThreads) return nullptr;
+
+        auto* pRing = reinterpret_cast<ring_header*>(&pBase[Header.m_RingsOffset + iRing * m_RingStride]);
+        pRing->m_ThreadID = std::hash<std::thread::id>{}(std::this_thread::get_id());
+        return Cache.m_pRing = pRing;
+    }
+
+    //------------------------------------------------------------------------------------
+    // The sequence is cleared before and set after the fields, so the reader can tell a record
+    // that was being written when the process died. Stores that retired reach the file even
+    // when the process is killed, so only the compiler has to keep them in order
+    inline void flight_recorder::Write(const char* pMessage, std::uint32_t Line) noexcept
+    {
+        auto* pRing = getRing();
+        if (pRing == nullptr) return;
+
+        const auto Index  = pRing->m_Head;
+        auto&      Record = reinterpret_cast<record*>(pRing + 1)[Index % m_RecordsPerThread];
+
+        std::atomic_ref<std::uint32_t>(Record.m_Sequence).store(0, std::memory_order_relaxed);
+        std::atomic_signal_fence(std::memory_order_release);
+
+        Record.m_SiteID     = GetInfo(pMessage).m_SiteID;
+        Record.m_Timestamp  = SystemNow();
+        Record.m_Line       = Line;
+        Record.m_State      = static_cast<std::uint8_t>(pMessage[-1]);
+
+        // The causes, newest first. The first node is this error when it was chained
+        std::uint8_t nLinks = 0;
+        auto         i      = g_iCurChain;
+        if (i != -1 && xerr::m_ChainPool.getError(i) == pMessage) i = xerr::m_ChainPool[i].m_iNext;
+        for (; i != -1 && nLinks < max_links_v; i = xerr::m_ChainPool[i].m_iNext)
+            Record.m_Links[nLinks++] = GetInfo(xerr::m_ChainPool.getError(i)).m_SiteID;
+        Record.m_nLinks = nLinks;
+
+        std::atomic_signal_fence(std::memory_order_release);
+        std::atomic_ref<std::uint32_t>(Record.m_Sequence).store(static_cast<std::uint32_t>(Index + 1), std::memory_order_release);
+        std::atomic_ref<std::uint64_t>(pRing->m_Head).store(Index + 1, std::memory_order_release);
+    }
+
+    //------------------------------------------------------------------------------------
+    // Called by ReportError for every error (declared in xerr_inline.h)
+    inline void RecordFlight(const char* pMessage, std::uint32_t Line) noexcept
+    {
+        g_FlightRecorder.Write(pMessage, Line);
+    }
+}
@@ -1,8 +1,66 @@
 
+#include <algorithm>
 #include <cassert>
+#include <charconv>
+#include <cstddef>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <utility>
+
+#if __has_include(<dlfcn.h>)
+    #include <dlfcn.h>
+#endif
+#if __has_include(<cxxabi.h>)
+    #include <cxxabi.h>
+#endif
+#if defined(__linux__) && __has_include(<linux/membarrier.h>)
+    #include <linux/membarrier.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
 
 namespace xerr_details
 {
+    //------------------------------------------------------------------------------------
+    // 64 bit FNV-1a, used for the stable site IDs
+    //------------------------------------------------------------------------------------
+    namespace details
+    {
+        constexpr std::uint64_t fnv1a_offset_v = 14695981039346656037ull;
+
+        constexpr std::uint64_t Fnv1a(std::uint64_t Hash, char C) noexcept
+        {
+            return (Hash ^ static_cast<std::uint8_t>(C)) * 1099511628211ull;
+        }
+
+        constexpr bool StartsWith(const char* pStr, const char* pEnd, const char* pPrefix) noexcept
+        {
+            for (; *pPrefix; ++pStr, ++pPrefix) if (pStr == pEnd || *pStr != *pPrefix) return false;
+            return true;
+        }
+
+        // Hashes a type name as the compiler prints it, skipping the decorations that differ
+        // between MSVC, Clang and GCC so the hash is the same with all of them
+        consteval std::uint64_t HashTypeName(const char* pBegin, const char* pEnd, std::uint64_t Hash) noexcept
+        {
+            for (const char* p = pBegin; p < pEnd; )
+            {
+                const bool bWordStart = p == pBegin || !((p[-1] >= 'a' && p[-1] <= 'z') || (p[-1] >= 'A' && p[-1] <= 'Z') || (p[-1] >= '0' && p[-1] <= '9') || p[-1] == '_');
+
+                if      (bWordStart && StartsWith(p, pEnd, "enum "))            p += 5;
+                else if (bWordStart && StartsWith(p, pEnd, "class "))           p += 6;
+                else if (bWordStart && StartsWith(p, pEnd, "struct "))          p += 7;
+                else if (StartsWith(p, pEnd, "(anonymous namespace)"))          { p += 21; for (const char* a = "{anonymous}"; *a; ++a) Hash = Fnv1a(Hash, *a); }
+                else if (StartsWith(p, pEnd, "`anonymous namespace'"))          { p += 21; for (const char* a = "{anonymous}"; *a; ++a) Hash = Fnv1a(Hash, *a); }
+                else if (*p == ' ')                                             ++p;
+                else                                                            Hash = Fnv1a(Hash, *p++);
+            }
+            return Hash;
+        }
+    }
+
     // Simple constexpr hash function for strings
     // djb2 hash algorithm
 #if defined(_MSC_VER)
@@ -23,439 +81,2538 @@ namespace xerr_details
 
     namespace details
     {
-        template<auto T>
-        consteval auto getValueTypeName() noexcept
-        {
-            constexpr const char* sig = __FUNCSIG__;
-            constexpr std::size_t len = [&] {
-                std::size_t i = 0;
-                while (sig[i] != '\0') ++i;
-                return i;
-                }();
-
-            constexpr const char* prefix = "getValueTypeName<";
-            constexpr std::size_t prefix_len = [&] {
-                std::size_t i = 0;
-                while (prefix[i] != '\0') ++i;
-                return i;
-                }();
-
-            std::size_t start = 0;
-            for (std::size_t i = 0; i < len - prefix_len; ++i)
+        // Signature naming the value, cheap to instantiate. ParseValueName finds the name in it
+        template<auto T_VALUE_V>
+        consteval const char* getValueSignature() noexcept
+        {
+            return __FUNCSIG__;
+        }
+
+        // "Enum::VALUE" of an enumerator, empty when the value has no name
+        // The text before the value is the same for every value, so its length is measured once
+        consteval std::size_t getValueNameStart(const char* pSig) noexcept
+        {
+            constexpr std::string_view Prefix = "getValueSignature<";
+            return std::string_view{ pSig }.find(Prefix) + Prefix.size();
+        }
+
+        consteval std::string_view ParseValueName(const char* pSig, std::size_t Start) noexcept
+        {
+            const char* pName = pSig + Start;
+            if (*pName == '(' || *pName == '-' || (*pName >= '0' && *pName <= '9')) return {};
+
+            // The value ends at the last '>' before the parameter list
+            std::size_t Length = 0;
+            for (std::size_t i = 0; pName[i] && pName[i] != '('; ++i) if (pName[i] == '>') Length = i;
+            return { pName, Length };
+        }
+
+        //------------------------------------------------------------------------------------
+
+        template<typename T>
+        consteval std::uint64_t getTypeNameHash(std::uint64_t Hash) noexcept
+        {
+            constexpr const char* sig    = __FUNCSIG__;
+            constexpr const char* prefix = "getTypeNameHash<";
+
+            const char* pStart = sig;
+            while (*pStart && !StartsWith(pStart, nullptr, prefix)) ++pStart;
+            pStart += 16;
+
+            // The type ends at the last '>' before the parameter list
+            const char* pEnd = pStart;
+            for (const char* p = pStart; *p && *p != '('; ++p) if (*p == '>') pEnd = p;
+
+            return HashTypeName(pStart, pEnd, Hash);
+        }
+    }
+#else
+
+    //------------------------------------------------------------------------------------
+
+    template<typename T_STATE_ENUM>
+    consteval static uint32_t create_uid(void) noexcept
+    {
+        const char*     s       = __PRETTY_FUNCTION__;
+        std::uint32_t   hash    = 5381;
+        for (int i = 0; (s[i]); ++i)  
+            hash = ((hash << 5) + hash) + s[i];
+        return hash;
+    }
+
+    //------------------------------------------------------------------------------------
+
+    namespace details
+    {
+        // Signature naming the value, cheap to instantiate. ParseValueName finds the name in it
+        template<auto T_VALUE_V>
+        consteval const char* getValueSignature() noexcept
+        {
+            return __PRETTY_FUNCTION__;
+        }
+
+        // "Enum::VALUE" of an enumerator, empty when the value has no name (printed as "(Enum)5")
+        // The text before the value is the same for every value, so its length is measured once
+        consteval std::size_t getValueNameStart(const char* pSig) noexcept
+        {
+            constexpr std::string_view Prefix = "T_VALUE_V = ";
+            return std::string_view{ pSig }.find(Prefix) + Prefix.size();
+        }
+
+        consteval std::string_view ParseValueName(const char* pSig, std::size_t Start) noexcept
+        {
+            const char* pName = pSig + Start;
+            if (*pName == '(' || *pName == '-' || (*pName >= '0' && *pName <= '9')) return {};
+
+            std::size_t Length = 0;
+            while (pName[Length] != ']' && pName[Length] != ';' && pName[Length] != '\0') ++Length;
+            return { pName, Length };
+        }
+
+        //------------------------------------------------------------------------------------
+
+        template<typename T>
+        consteval std::uint64_t getTypeNameHash(std::uint64_t Hash) noexcept
+        {
+            constexpr const char* sig = __PRETTY_FUNCTION__;
+
+            const char* pStart = sig;
+            while (*pStart && !StartsWith(pStart, nullptr, "T = ")) ++pStart;
+            pStart += 4;
+
+            const char* pEnd = pStart;
+            while (*pEnd != ']' && *pEnd != ';' && *pEnd != '\0') ++pEnd;
+
+            return HashTypeName(pStart, pEnd, Hash);
+        }
+    }
+#endif
+
+    //------------------------------------------------------------------------------------
+
+    //------------------------------------------------------------------------------------
+
+    // Template to get a unique 32 bit ID form a type
+    // Cross-compiler macro for type name
+    template<typename T_STATE_ENUM>
+    inline constexpr static uint32_t uid_v = create_uid<T_STATE_ENUM>();
+
+    //------------------------------------------------------------------------------------
+    // STATE NAMES
+    //------------------------------------------------------------------------------------
+
+    // States are one byte enums, signed enums store negative states as the bytes 128..255
+    template< typename T_STATE_ENUM >
+    using state_byte = std::conditional_t< std::is_signed_v<std::underlying_type_t<T_STATE_ENUM>>, signed char, unsigned char >;
+
+    // Values are scanned from 0 by blocks, up to the first block without an enumerator. Most enums
+    // only need the first block, enumerators past a gap that long (or negative ones) are not in
+    // the table and get their name from the catalog instead (see xerr::getStateName)
+    constexpr static std::size_t state_block_size_v = 8;
+
+    struct state_block
+    {
+        std::array<std::string_view, state_block_size_v>    m_Names;
+        bool                                                m_bNamed;   // Some value of the block is an enumerator
+    };
+
+    template< typename T_STATE_ENUM, std::size_t T_FIRST_V >
+    inline constexpr auto state_block_v = []<std::size_t... T_BYTES_V>(std::index_sequence<T_BYTES_V...>) consteval noexcept
+    {
+        // Instantiating the signatures is cheap, parsing them all in one loop keeps the build fast
+        const std::array<const char*, state_block_size_v> Signatures{ details::getValueSignature<static_cast<T_STATE_ENUM>(static_cast<state_byte<T_STATE_ENUM>>(T_FIRST_V + T_BYTES_V))>()... };
+
+        state_block Block{};
+        const auto  Start = details::getValueNameStart(Signatures[0]);
+        for (std::size_t i = 0; i < state_block_size_v; ++i)
+        {
+            Block.m_Names[i] = details::ParseValueName(Signatures[i], Start);
+            Block.m_bNamed  |= Block.m_Names[i].empty() == false;
+        }
+        return Block;
+    }(std::make_index_sequence<state_block_size_v>{});
+
+    template< typename T_STATE_ENUM, std::size_t T_FIRST_V = 0 >
+    consteval auto ScanStateNames(void) noexcept
+    {
+        if constexpr (T_FIRST_V == 256) return std::array<std::string_view, 256>{};
+        else if constexpr (state_block_v<T_STATE_ENUM, T_FIRST_V>.m_bNamed == false) return std::array<std::string_view, T_FIRST_V>{};
+        else
+        {
+            auto Names = ScanStateNames<T_STATE_ENUM, T_FIRST_V + state_block_size_v>();
+            for (std::size_t i = 0; i < state_block_size_v; ++i) Names[T_FIRST_V + i] = state_block_v<T_STATE_ENUM, T_FIRST_V>.m_Names[i];
+            return Names;
+        }
+    }
+
+    // Name of every scanned state byte of an enum, empty for the bytes without an enumerator
+    template< typename T_STATE_ENUM >
+    inline constexpr auto state_value_names_v = ScanStateNames<T_STATE_ENUM>();
+
+    // Scanned name of a state byte, empty when xerr::report_policy filters the state
+    template< typename T_STATE_ENUM >
+    constexpr std::string_view getReportedStateName(std::size_t i) noexcept
+    {
+        const auto State = static_cast<T_STATE_ENUM>(static_cast<state_byte<T_STATE_ENUM>>(i));
+        if (XERR_REPORTING == 0 || xerr::report_policy<T_STATE_ENUM>::isReported(State) == false) return {};
+        return state_value_names_v<T_STATE_ENUM>[i];
+    }
+
+    //------------------------------------------------------------------------------------
+    // One packed table per enum: the names back to back with their terminators, and the offset of
+    // the name of each state byte up to the last one with a name (none_v for the unnamed ones).
+    // States filtered by xerr::report_policy are left out so their names stay out of the binary
+    template< typename T_STATE_ENUM >
+    struct state_names
+    {
+        constexpr static std::uint16_t none_v = 0xffff;
+
+        constexpr static std::size_t count_v = []() consteval noexcept
+        {
+            std::size_t Count = 0;
+            for (std::size_t i = 0; i < state_value_names_v<T_STATE_ENUM>.size(); ++i) if (getReportedStateName<T_STATE_ENUM>(i).empty() == false) Count = i + 1;
+            return Count;
+        }();
+
+        constexpr static std::size_t chars_v = []() consteval noexcept
+        {
+            std::size_t Chars = 0;
+            for (std::size_t i = 0; i < count_v; ++i) if (const auto Name = getReportedStateName<T_STATE_ENUM>(i); Name.empty() == false) Chars += Name.size() + 1;
+            return Chars;
+        }();
+
+        static_assert(chars_v < none_v, "xerr state names of this enum do not fit in the table");
+
+        struct table
+        {
+            std::array<char, chars_v ? chars_v : 1>             m_Names;
+            std::array<std::uint16_t, count_v ? count_v : 1>    m_Offset;
+        };
+
+        constexpr static table table_v = []() consteval noexcept
+        {
+            table Table{};
+            Table.m_Offset.fill(none_v);
+
+            std::size_t Chars = 0;
+            for (std::size_t i = 0; i < count_v; ++i)
             {
-                bool match = true;
-                for (std::size_t j = 0; j < prefix_len; ++j)
-                {
-                    if (sig[i + j] != prefix[j])
-                    {
-                        match = false;
-                        break;
-                    }
-                }
-                if (match)
-                {
-                    start = i + prefix_len;
-                    break;
-                }
+                const auto Name = getReportedStateName<T_STATE_ENUM>(i);
+                if (Name.empty()) continue;
+
+                Table.m_Offset[i] = static_cast<std::uint16_t>(Chars);
+                for (char C : Name) Table.m_Names[Chars++] = C;
+                Table.m_Names[Chars++] = 0;
+            }
+            return Table;
+        }();
+
+        consteval static const char* getName(std::uint8_t State) noexcept
+        {
+            return State < count_v && table_v.m_Offset[State] != none_v ? &table_v.m_Names[table_v.m_Offset[State]] : "";
+        }
+    };
+
+    //------------------------------------------------------------------------------------
+
+    // Name of an enumerator the scan did not reach, only instantiated for the states that use one
+    template< auto T_STATE_V >
+    inline constexpr auto state_value_name_v = []() consteval noexcept
+    {
+        constexpr const char*      pSig = details::getValueSignature<T_STATE_V>();
+        constexpr std::string_view Name = details::ParseValueName(pSig, details::getValueNameStart(pSig));
+
+        std::array<char, Name.size() + 1> Chars{};
+        for (std::size_t i = 0; i < Name.size(); ++i) Chars[i] = Name[i];
+        return Chars;
+    }();
+
+    //------------------------------------------------------------------------------------
+
+    template< auto T_STATE_V >
+    consteval const char* getStateValueName(void) noexcept
+    {
+        using enum_t = decltype(T_STATE_V);
+        if constexpr (static_cast<std::uint8_t>(T_STATE_V) < state_value_names_v<enum_t>.size()) return state_names<enum_t>::getName(static_cast<std::uint8_t>(T_STATE_V));
+        else                                                                                      return state_value_name_v<T_STATE_V>.data();
+    }
+
+    //------------------------------------------------------------------------------------
+    // States that are not reported do not get their name string instantiated
+    template< auto T_STATE_V >
+    consteval const char* getStateName(void) noexcept
+    {
+        if constexpr (xerr::is_reported_v<T_STATE_V>) return getStateValueName<T_STATE_V>();
+        else                                          return "";
+    }
+
+    //------------------------------------------------------------------------------------
+
+    // Stable 64 bit ID of an error site. It only depends on the enum type name, the state and
+    // the message so it is the same across builds, compilers and shared objects. Never 0
+    constexpr std::uint64_t create_site_id(std::uint64_t TypeNameHash, char State, const char* pMessage) noexcept
+    {
+        auto Hash = details::Fnv1a(TypeNameHash, ':');
+        Hash = details::Fnv1a(Hash, State);
+        for (std::size_t i = 0; pMessage[i]; ++i) Hash = details::Fnv1a(Hash, pMessage[i]);
+        return Hash ? Hash : 1;
+    }
+
+    template <string_literal T_STR_V, auto T_STATE_V>
+    consteval std::uint64_t create_site_id(void) noexcept
+    {
+        return create_site_id(details::getTypeNameHash<decltype(T_STATE_V)>(details::fnv1a_offset_v), static_cast<char>(T_STATE_V), T_STR_V.m_Value.data());
+    }
+
+    //------------------------------------------------------------------------------------
+
+    // The message is preceded by its header so xerr can get to everything from m_pMessage.
+    // m_Message[-1] is the state, m_Message[-5] the type GUID, and before those the split
+    // offsets of the "message|hint" string which are computed at compile time
+    template< std::size_t T_SIZE_V >
+    struct info_construct
+    {
+        std::uint64_t m_SiteID;             // See create_site_id
+        std::uint16_t m_MessageLength;      // Characters before the '|' (or the whole string)
+        std::uint16_t m_HintOffset;         // Offset of the hint from m_Message, points at the terminator when there is no hint
+        std::uint16_t m_HintLength;         // Characters after the '|'
+        std::uint16_t m_nArgs;              // Number of {} that runtime arguments can fill
+        std::uint32_t m_TypeGUID;
+        char          m_State;
+        char          m_Message[T_SIZE_V];
+    };
+
+    static_assert(offsetof(info_construct<1>, m_Message) - offsetof(info_construct<1>, m_State)    == 1);
+    static_assert(offsetof(info_construct<1>, m_Message) - offsetof(info_construct<1>, m_TypeGUID) == 5);
+
+    // xerr::result counts on every message pointer being odd
+    static_assert(offsetof(info_construct<1>, m_Message) % 2 == 1 && alignof(info_construct<1>) % 2 == 0);
+    static_assert(offsetof(info_construct<1>, m_Message) == 21);
+
+    //------------------------------------------------------------------------------------
+
+    inline const info_construct<1>& GetInfo(const char* pMessage) noexcept
+    {
+        return *reinterpret_cast<const info_construct<1>*>(pMessage - offsetof(info_construct<1>, m_Message));
+    }
+
+    //------------------------------------------------------------------------------------
+
+    template <string_literal T_STR_V, auto T_STATE_V>
+    inline constexpr static auto data_v = []() consteval noexcept
+    {
+        static_assert(T_STR_V.m_Value.size() <= 0xffff, "xerr message is too long");
+
+        auto a = info_construct<T_STR_V.m_Value.size()>{};
+        a.m_SiteID   = create_site_id<T_STR_V, T_STATE_V>();
+        a.m_TypeGUID = uid_v<decltype(T_STATE_V)>;
+        a.m_State = static_cast<char>(T_STATE_V);
+
+        std::size_t i = 0;
+        while ((a.m_Message[i] = T_STR_V.m_Value[i]) && a.m_Message[i] != '|') ++i;
+        a.m_MessageLength = static_cast<std::uint16_t>(i);
+        a.m_HintOffset    = static_cast<std::uint16_t>(a.m_Message[i] ? i + 1 : i);
+        for (; (a.m_Message[i] = T_STR_V.m_Value[i]); ++i) {}
+        a.m_HintLength    = static_cast<std::uint16_t>(i - a.m_HintOffset);
+        for (std::size_t j = 0; j + 1 < i; ++j) if (a.m_Message[j] == '{' && a.m_Message[j + 1] == '}') ++a.m_nArgs;
+        return a;
+    }();
+
+    //------------------------------------------------------------------------------------
+    // Stand ins for the sites xerr::Deserialize does not find in the catalog, one per state byte so
+    // the error keeps the state the sender recorded. Built the first time they are needed, at
+    // compile time the 256 copies would cost every translation unit
+    constexpr static string_literal remote_error_message_v = "Unknown remote error|The error site is not in this binary's catalog";
+    using remote_error = std::remove_cvref_t<decltype(data_v<remote_error_message_v, xerr::default_states::FAILURE>)>;
+
+    inline std::span<const remote_error, 256> getRemoteErrors(void) noexcept
+    {
+        static const auto Errors = []() noexcept
+        {
+            const auto& Data = data_v<remote_error_message_v, xerr::default_states::FAILURE>;
+            const auto  Hash = details::getTypeNameHash<xerr::default_states>(details::fnv1a_offset_v);
+
+            std::array<remote_error, 256> Errors;
+            for (std::size_t i = 0; i < Errors.size(); ++i)
+            {
+                Errors[i]          = Data;
+                Errors[i].m_State  = static_cast<char>(i);
+                Errors[i].m_SiteID = create_site_id(Hash, static_cast<char>(i), Data.m_Message);
             }
+            return Errors;
+        }();
+
+        return Errors;
+    }
+
+    inline bool isRemoteError(const char* pMessage) noexcept
+    {
+        const auto Errors  = getRemoteErrors();
+        const auto Address = reinterpret_cast<std::uintptr_t>(pMessage);
+        return Address >= reinterpret_cast<std::uintptr_t>(Errors.data()) && Address < reinterpret_cast<std::uintptr_t>(Errors.data() + Errors.size());
+    }
+
+    //------------------------------------------------------------------------------------
+    // Runs a full memory barrier on every running thread of the process, so a thread that only
+    // has a compiler fence between a store and a load is ordered against the caller. The magazine
+    // owners rely on it to stay off locked instructions, the rare Reclaim pays instead.
+    // bRegister announces the use once at startup. Returns false when the OS has no such barrier
+#if defined(_WIN32)
+    extern "C" __declspec(dllimport) void __stdcall FlushProcessWriteBuffers(void);
+#endif
+
+    inline bool ProcessBarrier(bool bRegister) noexcept
+    {
+#if defined(_WIN32)
+        if (bRegister == false) FlushProcessWriteBuffers();
+        return true;
+#elif defined(__linux__) && __has_include(<linux/membarrier.h>)
+        return syscall(SYS_membarrier, bRegister ? MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED : MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0, 0) == 0;
+#else
+        (void)bRegister;
+        return false;
+#endif
+    }
+
+    //------------------------------------------------------------------------------------
+
+    inline chain_pool::chain_pool(void) noexcept
+    {
+        // In segmented mode the pool starts empty and Grow adds the nodes on demand
+        if constexpr (segmented_v == false)
+        {
+            for (index i = 0; i < static_cast<index>(capacity_v); ++i) (*this)[i].m_iNext = i + 1;
+            (*this)[static_cast<index>(capacity_v - 1)].m_iNext = -1;
+            m_Empty.store(Pack(0, 0), std::memory_order_relaxed);
+        }
+
+        if constexpr (magazine_count_v != 0) m_bAsymmetric = ProcessBarrier(true);
+    }
+
+    //------------------------------------------------------------------------------------
+
+    inline chain_pool::~chain_pool(void) noexcept
+    {
+#if XERR_CHAIN_POOL_SEGMENT_SIZE
+        for (auto& Segment : m_Segments) delete[] Segment.load(std::memory_order_relaxed);
+#endif
+    }
+
+    //------------------------------------------------------------------------------------
+
+    inline chain_pool::node& chain_pool::operator[](index Index) noexcept
+    {
+#if XERR_CHAIN_POOL_SEGMENT_SIZE
+        return m_Segments[static_cast<std::uint32_t>(Index) >> segment_shift_v].load(std::memory_order_acquire)[Index & (segment_size_v - 1)];
+#else
+        return m_Pool[Index];
+#endif
+    }
+
+    //------------------------------------------------------------------------------------
+
+    inline const chain_pool::node& chain_pool::operator[](index Index) const noexcept
+    {
+        return const_cast<chain_pool&>(*this)[Index];
+    }
+
+    //------------------------------------------------------------------------------------
+    // Returns invalid_ref_v when the message is far and the far table is full
+    inline chain_pool::error_ref chain_pool::MakeRef(const char* pError) noexcept
+    {
+#if XERR_CHAIN_FAR_SIZE
+        const auto Offset = reinterpret_cast<std::intptr_t>(pError) - reinterpret_cast<std::intptr_t>(this);
+        if ((Offset & 1) && Offset >= std::numeric_limits<std::int32_t>::min() && Offset <= std::numeric_limits<std::int32_t>::max())
+            return static_cast<std::int32_t>(Offset);
+
+        // Open addressing on the pointer, a message keeps the slot it got the first time
+        const auto Hash = static_cast<std::size_t>((reinterpret_cast<std::uintptr_t>(pError) >> 3) * 0x9E3779B97F4A7C15ull);
+        for (std::size_t n = 0; n < far_size_v; ++n)
+        {
+            const auto  iSlot     = (Hash + n) & (far_size_v - 1);
+            const char* pExpected = m_Far[iSlot].load(std::memory_order_acquire);
+            if (pExpected == nullptr && m_Far[iSlot].compare_exchange_strong(pExpected, pError, std::memory_order_acq_rel))
+                return static_cast<std::int32_t>(iSlot * 2);
+            if (pExpected == pError)
+                return static_cast<std::int32_t>(iSlot * 2);
+        }
+
+        return invalid_ref_v;
+#else
+        return pError;
+#endif
+    }
+
+    //------------------------------------------------------------------------------------
+
+    inline const char* chain_pool::getError(index Index) const noexcept
+    {
+        const auto Ref = (*this)[Index].m_Error;
+#if XERR_CHAIN_FAR_SIZE
+        if (Ref & 1) return reinterpret_cast<const char*>(reinterpret_cast<std::intptr_t>(this) + Ref);
+        return m_Far[static_cast<std::uint32_t>(Ref) >> 1].load(std::memory_order_acquire);
+#else
+        return Ref;
+#endif
+    }
+
+    //------------------------------------------------------------------------------------
+
+    thread_local inline chain_pool::magazine_owner g_Magazine = {};
+
+    //------------------------------------------------------------------------------------
+    // When a thread dies its cached nodes go back to the global list and its magazine to the next thread
+    inline chain_pool::magazine_owner::~magazine_owner(void) noexcept
+    {
+        if (m_pMagazine == nullptr) return;
+
+        auto& Magazine = *m_pMagazine;
+        while (xerr::m_ChainPool.Enter(Magazine) == false) {}      // Reclaim only holds it for a moment
+        if (Magazine.m_Count) xerr::m_ChainPool.Spill(Magazine, Magazine.m_Count);
+        chain_pool::Leave(Magazine);
+        Magazine.m_bTaken.store(false, std::memory_order_release);
+        xerr::m_ChainPool.m_nReleases.fetch_add(1, std::memory_order_release);
+        m_pMagazine = nullptr;
+    }
+
+    //------------------------------------------------------------------------------------
+    // Lockless pop of up to Count nodes from the global free list with a single CAS
+    inline int chain_pool::PopBatch(index* pIndex, int Count) noexcept
+    {
+        head Head = m_Empty.load(std::memory_order_acquire);
+        while (UnpackIndex(Head) != -1)
+        {
+            // The walk may read nodes that other threads are popping, but any pop or push
+            // bumps the tag so the CAS below fails and we try again with a fresh head
+            int   n    = 0;
+            index last = UnpackIndex(Head);
+            pIndex[n++] = last;
+            while (n < Count && (*this)[last].m_iNext != -1)
+            {
+                last        = (*this)[last].m_iNext;
+                pIndex[n++] = last;
+            }
+
+            if (m_Empty.compare_exchange_weak(Head, Pack((*this)[last].m_iNext, UnpackTag(Head) + 1), std::memory_order_acq_rel))
+                return n;
+        }
+
+        return 0;
+    }
+
+    //------------------------------------------------------------------------------------
+    // Lockless push of an already linked list of nodes (iFirst...iLast) to the global free list
+    inline void chain_pool::PushBatch(index iFirst, index iLast) noexcept
+    {
+        head old_head = m_Empty.load(std::memory_order_relaxed);
+        do
+        {
+            (*this)[iLast].m_iNext = UnpackIndex(old_head);
+
+        } while (!m_Empty.compare_exchange_weak(old_head, Pack(iFirst, UnpackTag(old_head) + 1), std::memory_order_acq_rel));
+    }
+
+    //------------------------------------------------------------------------------------
+
+    // Adds a segment of nodes to the global free list. Returns false when the pool can not grow
+    inline bool chain_pool::Grow(void) noexcept
+    {
+#if XERR_CHAIN_POOL_SEGMENT_SIZE
+        const auto iSegment = m_nSegments.load(std::memory_order_acquire);
+        if (iSegment == m_Segments.size()) return false;
+        if (m_Segments[iSegment].load(std::memory_order_acquire)) return true;
+
+        auto* pSegment = new (std::nothrow) node[segment_size_v];
+        if (pSegment == nullptr) return false;
+
+        // Only one thread gets to publish the segment, the rest simply try to pop again
+        node* pExpected = nullptr;
+        if (m_Segments[iSegment].compare_exchange_strong(pExpected, pSegment, std::memory_order_acq_rel) == false)
+        {
+            delete[] pSegment;
+            return true;
+        }
+
+        const auto iFirst = static_cast<index>(iSegment * segment_size_v);
+        for (std::size_t i = 0; i < segment_size_v; ++i) pSegment[i].m_iNext = static_cast<index>(iFirst + i + 1);
+        m_nSegments.store(iSegment + 1, std::memory_order_release);
+        PushBatch(iFirst, static_cast<index>(iFirst + segment_size_v - 1));
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    //------------------------------------------------------------------------------------
+
+    inline chain_pool::index chain_pool::Alloc(void) noexcept
+    {
+        do
+        {
+            // A magazine Reclaim is emptying at this moment is skipped, the global list is used instead
+            index Index    = -1;
+            auto* pMagazine = getMagazine();
+            if (pMagazine && Enter(*pMagazine))
+            {
+                if (pMagazine->m_Count == 0) pMagazine->m_Count = static_cast<std::int16_t>(PopBatch(pMagazine->m_Index.data(), magazine_batch_v));
+                if (pMagazine->m_Count)      Index = pMagazine->m_Index[--pMagazine->m_Count];
+                Leave(*pMagazine);
+            }
+            else
+            {
+                PopBatch(&Index, 1);
+            }
+
+            if (Index != -1) return Index;
+
+        } while ((segmented_v && Grow()) || Reclaim());
+
+        // Pool exhausted, the caller applies the exhaustion policy
+        return -1;
+    }
+
+    //------------------------------------------------------------------------------------
+    // Magazine of the calling thread, nullptr when every magazine is taken (or they are disabled)
+    inline chain_pool::magazine* chain_pool::getMagazine(void) noexcept
+    {
+        if constexpr (magazine_count_v == 0)
+        {
+            return nullptr;
+        }
+        else
+        {
+            auto& Owner = g_Magazine;
+            if (Owner.m_pMagazine) return Owner.m_pMagazine;
+
+            // Only look again when a thread handed one back since the last attempt
+            const auto nReleases = m_nReleases.load(std::memory_order_acquire);
+            if (Owner.m_nReleases == nReleases) return nullptr;
+            Owner.m_nReleases = nReleases;
+
+            for (auto& Magazine : m_Magazines)
+            {
+                bool bTaken = false;
+                if (Magazine.m_bTaken.load(std::memory_order_relaxed) == false && Magazine.m_bTaken.compare_exchange_strong(bTaken, true, std::memory_order_acquire))
+                    return Owner.m_pMagazine = &Magazine;
+            }
+
+            return nullptr;
+        }
+    }
+
+    //------------------------------------------------------------------------------------
+    // The owner flags its magazine busy before it touches it. Reclaim does the opposite (flags
+    // m_bReclaim, then looks at m_bBusy) with a ProcessBarrier in between, so the owner only
+    // needs a compiler fence: either Reclaim sees it busy or the owner sees the reclaim. Without
+    // ProcessBarrier both sides use a full fence. Returns false when Reclaim has the magazine
+    inline bool chain_pool::Enter(magazine& Magazine) noexcept
+    {
+        Magazine.m_bBusy.store(true, std::memory_order_relaxed);
+        if (m_bAsymmetric) std::atomic_signal_fence(std::memory_order_seq_cst);
+        else               std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (Magazine.m_bReclaim.load(std::memory_order_acquire) == false) return true;
+
+        Magazine.m_bBusy.store(false, std::memory_order_relaxed);
+        return false;
+    }
+
+    //------------------------------------------------------------------------------------
+
+    inline void chain_pool::Leave(magazine& Magazine) noexcept
+    {
+        Magazine.m_bBusy.store(false, std::memory_order_release);
+    }
+
+    //------------------------------------------------------------------------------------
+    // Moves the Count latest nodes of a magazine (entered or reclaimed) to the global list
+    inline void chain_pool::Spill(magazine& Magazine, std::int16_t Count) noexcept
+    {
+        Magazine.m_Count -= Count;
+        const auto* pSpill = &Magazine.m_Index[Magazine.m_Count];
+        for (int j = 0; j < Count - 1; ++j) (*this)[pSpill[j]].m_iNext = pSpill[j + 1];
+        PushBatch(pSpill[0], pSpill[Count - 1]);
+    }
+
+    //------------------------------------------------------------------------------------
+    // The global list ran dry: takes back the nodes cached by the other threads, idle or not.
+    // Returns false when there was nothing to take, the pool is then really exhausted (give or
+    // take the magazines their owners are using at this very moment)
+    inline bool chain_pool::Reclaim(void) noexcept
+    {
+        if constexpr (magazine_count_v == 0)
+        {
+            return false;
+        }
+        else
+        {
+            while (m_bReclaiming.exchange(true, std::memory_order_acquire)) {}
+
+            for (auto& Magazine : m_Magazines)
+                if (Magazine.m_bTaken.load(std::memory_order_relaxed)) Magazine.m_bReclaim.store(true, std::memory_order_relaxed);
+
+            const bool bOrdered = m_bAsymmetric ? ProcessBarrier(false) : (std::atomic_thread_fence(std::memory_order_seq_cst), true);
+
+            // A magazine its owner is using right now is left alone
+            std::uint64_t nReclaimed = 0;
+            for (auto& Magazine : m_Magazines)
+            {
+                if (Magazine.m_bReclaim.load(std::memory_order_relaxed) == false) continue;
+
+                if (bOrdered && Magazine.m_bBusy.load(std::memory_order_acquire) == false && Magazine.m_Count)
+                {
+                    nReclaimed += static_cast<std::uint64_t>(Magazine.m_Count);
+                    Spill(Magazine, Magazine.m_Count);
+                }
+                Magazine.m_bReclaim.store(false, std::memory_order_release);
+            }
+
+            m_bReclaiming.store(false, std::memory_order_release);
+            if (nReclaimed == 0) return false;
+            m_ReclaimCount.fetch_add(nReclaimed, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    //------------------------------------------------------------------------------------
+    // Called when Alloc fails for the chain (iHead...iTail). Returns a node that the caller
+    // can use for the new link or -1 if the new link must be dropped
+    inline chain_pool::index chain_pool::Exhausted(index& iHead, index& iTail) noexcept
+    {
+        switch (m_ExhaustionPolicy)
+        {
+        case exhaustion_policy::TRUNCATE_OLDEST:
+            if (iTail != -1)
+            {
+                m_TruncateCount.fetch_add(1, std::memory_order_relaxed);
+
+                const index iOldest = iTail;
+                iTail = (*this)[iOldest].m_iPrev;
+                if (iTail == -1) iHead = -1;
+                else             (*this)[iTail].m_iNext = -1;
+                return iOldest;
+            }
+            // Nothing to truncate, so all we can do is drop the link
+            [[fallthrough]];
+        case exhaustion_policy::DROP_NEW:
+            m_DropCount.fetch_add(1, std::memory_order_relaxed);
+            return -1;
+        case exhaustion_policy::FAIL_FAST:
+            m_FailFastCount.fetch_add(1, std::memory_order_relaxed);
+            assert(false && "xerr chain_pool exhausted");
+            std::abort();
+        }
+
+        return -1;
+    }
+
+    //------------------------------------------------------------------------------------
+
+    inline void chain_pool::Free(index& iHead, index& iTail) noexcept
+    {
+        if (iHead == -1)
+        {
+            assert(iTail == -1);
+            return;
+        }
+
+        auto* pMagazine = getMagazine();
+        if (pMagazine == nullptr || Enter(*pMagazine) == false)
+        {
+            // Atomically push chain to free list
+            PushBatch(iHead, iTail);
+        }
+        else
+        {
+            // Keep the nodes in the thread cache, when it fills up spill a batch to the global list
+            auto& Magazine = *pMagazine;
+            for (index i = iHead, iNext; i != -1; i = iNext)
+            {
+                iNext = (i == iTail) ? index{ -1 } : (*this)[i].m_iNext;
+                if (Magazine.m_Count == magazine_size_v) Spill(Magazine, magazine_batch_v);
+                Magazine.m_Index[Magazine.m_Count++] = i;
+            }
+            Leave(Magazine);
+        }
+
+        iHead = iTail = -1;
+    }
+
+    //------------------------------------------------------------------------------------
+
+    thread_local inline chain_pool::index g_iCurChain = -1; // -1 means no chain
+    thread_local inline chain_pool::index g_iCurTail  = -1; // -1 means no chain
+
+    //------------------------------------------------------------------------------------
+
+    inline void CreateEntry(const char* pError) noexcept
+    {
+        const auto Ref = xerr::m_ChainPool.MakeRef(pError);
+#if XERR_CHAIN_FAR_SIZE
+        if (Ref == chain_pool::invalid_ref_v)
+        {
+            xerr::m_ChainPool.m_DropCount.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+#endif
+
+        auto iNewIndex = xerr::m_ChainPool.Alloc();
+        if (iNewIndex == -1)
+        {
+            iNewIndex = xerr::m_ChainPool.Exhausted(xerr_details::g_iCurChain, xerr_details::g_iCurTail);
+            if (iNewIndex == -1) return;
+        }
+
+        auto& Entry     = xerr::m_ChainPool[iNewIndex];
+        Entry.m_Error   = Ref;
+        Entry.m_iNext   = xerr_details::g_iCurChain;
+        Entry.m_iPrev   = -1;
+
+        if (xerr_details::g_iCurChain != -1) xerr::m_ChainPool[xerr_details::g_iCurChain].m_iPrev = iNewIndex;
+        else                                 xerr_details::g_iCurTail = iNewIndex;
+        xerr_details::g_iCurChain = iNewIndex;
+    };
+
+    //------------------------------------------------------------------------------------
+    // CONTEXT
+    //------------------------------------------------------------------------------------
+
+    template< typename T >
+    constexpr context_arg MakeContextArg(const T& Value) noexcept
+    {
+        if constexpr (std::is_enum_v<T>)
+        {
+            return MakeContextArg(static_cast<std::underlying_type_t<T>>(Value));
+        }
+        else if constexpr (std::is_same_v<T, bool> || std::is_unsigned_v<T>)
+        {
+            return { context_arg::kind::UNSIGNED, static_cast<std::uint64_t>(Value), {} };
+        }
+        else if constexpr (std::is_integral_v<T>)
+        {
+            return { context_arg::kind::SIGNED, static_cast<std::uint64_t>(static_cast<std::int64_t>(Value)), {} };
+        }
+        else if constexpr (std::is_convertible_v<const T&, const char*>)
+        {
+            const char* pString = Value;
+            return { context_arg::kind::STRING, 0, pString ? std::string_view{ pString } : std::string_view{ "(null)" } };
+        }
+        else if constexpr (std::is_convertible_v<const T&, std::string_view>)
+        {
+            return { context_arg::kind::STRING, 0, std::string_view{ Value } };
+        }
+        else if constexpr (std::is_pointer_v<T> || std::is_null_pointer_v<T>)
+        {
+            return { context_arg::kind::POINTER, reinterpret_cast<std::uintptr_t>(static_cast<const volatile void*>(Value)), {} };
+        }
+        else
+        {
+            static_assert(sizeof(T) == 0, "xerr::args takes integers, enums, pointers and strings");
+        }
+    }
+
+    //------------------------------------------------------------------------------------
+    // Serializes the arguments into Buffer, strings are truncated to what fits. Returns the size.
+    // Variable sized copies use std::copy_n, a bounded memcpy gets inlined as a slow rep movs
+    inline std::size_t WriteContext(std::span<const context_arg> Args, std::span<std::byte> Buffer) noexcept
+    {
+        std::size_t n = 0;
+        for (const auto& Arg : Args)
+        {
+            if (Arg.m_Kind == context_arg::kind::STRING)
+            {
+                if (Buffer.size() - n < 2) break;
+                const auto Length = std::min({ Arg.m_String.size(), context_arena::max_string_v, Buffer.size() - n - 2 });
+                Buffer[n++] = static_cast<std::byte>(Arg.m_Kind);
+                Buffer[n++] = static_cast<std::byte>(Length);
+                std::copy_n(reinterpret_cast<const std::byte*>(Arg.m_String.data()), Length, &Buffer[n]);
+                n += Length;
+            }
+            else
+            {
+                if (Buffer.size() - n < 1 + sizeof(Arg.m_Value)) break;
+                Buffer[n++] = static_cast<std::byte>(Arg.m_Kind);
+                std::memcpy(&Buffer[n], &Arg.m_Value, sizeof(Arg.m_Value));
+                n += sizeof(Arg.m_Value);
+            }
+        }
+        return n;
+    }
+
+    //------------------------------------------------------------------------------------
+    // Copies serialized arguments into a smaller buffer, truncating the strings to fit
+    inline std::size_t CopyContext(std::span<const std::byte> Args, std::span<std::byte> Buffer) noexcept
+    {
+        std::size_t n = 0;
+        for (std::size_t i = 0; i < Args.size(); )
+        {
+            if (static_cast<context_arg::kind>(Args[i]) == context_arg::kind::STRING)
+            {
+                if (Buffer.size() - n < 2) break;
+                const auto Size   = static_cast<std::size_t>(Args[i + 1]);
+                const auto Length = std::min(Size, Buffer.size() - n - 2);
+                Buffer[n++] = Args[i];
+                Buffer[n++] = static_cast<std::byte>(Length);
+                std::copy_n(&Args[i + 2], Length, &Buffer[n]);
+                n += Length;
+                i += 2 + Size;
+            }
+            else
+            {
+                if (Buffer.size() - n < 1 + sizeof(std::uint64_t)) break;
+                std::memcpy(&Buffer[n], &Args[i], 1 + sizeof(std::uint64_t));
+                n += 1 + sizeof(std::uint64_t);
+                i += 1 + sizeof(std::uint64_t);
+            }
+        }
+        return n;
+    }
+
+    //------------------------------------------------------------------------------------
+    // Characters the formatted arguments can take at most
+    inline std::size_t getContextTextSize(std::span<const context_arg> Args) noexcept
+    {
+        std::size_t n = 0;
+        for (const auto& Arg : Args)
+        {
+            switch (Arg.m_Kind)
+            {
+            case context_arg::kind::SIGNED:     n += 20; break;
+            case context_arg::kind::UNSIGNED:   n += 20; break;
+            case context_arg::kind::POINTER:    n += 2 + 2 * sizeof(std::uint64_t); break;
+            case context_arg::kind::STRING:     n += std::min(Arg.m_String.size(), context_arena::max_string_v); break;
+            }
+        }
+        return n;
+    }
+
+    //------------------------------------------------------------------------------------
+    // Replaces each {} of the message of pMessage with the next serialized argument and writes
+    // the text into Buffer (it is always terminated). Returns the length and the length of the
+    // message part (before the '|' of the original message)
+    inline std::size_t FormatContext(const char* pMessage, std::span<const std::byte> Args, std::span<char> Buffer, std::size_t& MessageLength) noexcept
+    {
+        const auto&  Info   = GetInfo(pMessage);
+        const auto   Length = static_cast<std::size_t>(Info.m_HintOffset + Info.m_HintLength);
+        const auto   End    = Buffer.size() ? Buffer.size() - 1 : 0;
+        std::size_t  n      = 0;
+        std::size_t  iArg   = 0;
+
+        MessageLength = ~std::size_t{ 0 };
+        for (std::size_t i = 0; i < Length && n < End; ++i)
+        {
+            if (i == Info.m_MessageLength) MessageLength = n;
+
+            if (pMessage[i] != '{' || i + 1 >= Length || pMessage[i + 1] != '}' || iArg >= Args.size())
+            {
+                Buffer[n++] = pMessage[i];
+                continue;
+            }
+
+            ++i;
+            const auto Kind = static_cast<context_arg::kind>(Args[iArg++]);
+            if (Kind == context_arg::kind::STRING)
+            {
+                const auto Size = std::min(static_cast<std::size_t>(Args[iArg]), Args.size() - iArg - 1);
+                const auto Copy = std::min(Size, End - n);
+                std::copy_n(reinterpret_cast<const char*>(&Args[iArg + 1]), Copy, &Buffer[n]);
+                n    += Copy;
+                iArg += 1 + Size;
+            }
+            else
+            {
+                std::uint64_t Value;
+                std::memcpy(&Value, &Args[iArg], sizeof(Value));
+                iArg += sizeof(Value);
+
+                char  Digits[24];
+                char* pEnd = Digits;
+                if      (Kind == context_arg::kind::SIGNED)     pEnd = std::to_chars(Digits, std::end(Digits), static_cast<std::int64_t>(Value)).ptr;
+                else if (Kind == context_arg::kind::UNSIGNED)   pEnd = std::to_chars(Digits, std::end(Digits), Value).ptr;
+                else
+                {
+                    *pEnd++ = '0';
+                    *pEnd++ = 'x';
+                    pEnd = std::to_chars(pEnd, std::end(Digits), Value, 16).ptr;
+                }
+
+                const auto Copy = std::min(static_cast<std::size_t>(pEnd - Digits), End - n);
+                std::copy_n(Digits, Copy, &Buffer[n]);
+                n += Copy;
+            }
+        }
+
+        if (MessageLength > n) MessageLength = n;
+        if (Buffer.size()) Buffer[n] = 0;
+        return n;
+    }
+
+    //------------------------------------------------------------------------------------
+
+    inline std::span<const std::byte> context_arena::entry::getArgs(void) const noexcept
+    {
+        return { reinterpret_cast<const std::byte*>(this + 1), m_ArgsSize };
+    }
+
+    //------------------------------------------------------------------------------------
+    // Formats the error into pText (Capacity characters plus the terminator) and writes a copy of
+    // its info_construct header, with the new lengths, in front. The text then works with the
+    // functions that take message pointers (getMessageFromString, getHintFromString...)
+    inline const char* FormatContextText(const char* pMessage, std::span<const std::byte> Args, char* pText, std::size_t Capacity) noexcept
+    {
+        auto& Info = *reinterpret_cast<info_construct<1>*>(pText - offsetof(info_construct<1>, m_Message));
+        std::memcpy(&Info, &GetInfo(pMessage), offsetof(info_construct<1>, m_Message));
+
+        std::size_t MessageLength;
+        const auto  Length = FormatContext(pMessage, Args, { pText, Capacity + 1 }, MessageLength);
+        const bool  bHint  = MessageLength < Length;
+
+        Info.m_MessageLength = static_cast<std::uint16_t>(MessageLength);
+        Info.m_HintOffset    = static_cast<std::uint16_t>(bHint ? MessageLength + 1 : Length);
+        Info.m_HintLength    = static_cast<std::uint16_t>(bHint ? Length - MessageLength - 1 : 0);
+        Info.m_nArgs         = 0;
+        return pText;
+    }
+
+    //------------------------------------------------------------------------------------
+    // Formats the text the first time it is needed
+    inline const char* context_arena::entry::getText(void) noexcept
+    {
+        auto* pText = reinterpret_cast<char*>(this) + m_TextOffset;
+        if (m_bFormatted) return pText;
+
+        m_bFormatted = true;
+        return FormatContextText(m_pMessage, getArgs(), pText, m_TextCapacity);
+    }
+
+    //------------------------------------------------------------------------------------
+    // Returns nullptr when the arena is disabled or the entry would not fit in it
+    inline context_arena::entry* context_arena::Capture(const char* pMessage, std::span<const context_arg> Args) noexcept
+    {
+        if constexpr (size_v == 0) return nullptr;
+        else
+        {
+            static_assert(size_v % 8 == 0, "XERR_CONTEXT_ARENA_SIZE must be a multiple of 8");
+            constexpr std::size_t info_v  = offsetof(info_construct<1>, m_Message);
+            constexpr auto        Align   = [](std::size_t n) constexpr noexcept { return (n + 7) & ~std::size_t{ 7 }; };
+
+            std::size_t ArgsSize = 0;
+            for (const auto& Arg : Args) ArgsSize += Arg.m_Kind == context_arg::kind::STRING ? 2 + std::min(Arg.m_String.size(), max_string_v) : 1 + sizeof(Arg.m_Value);
+
+            const auto& Info         = GetInfo(pMessage);
+            const auto  TextCapacity = Info.m_HintOffset + Info.m_HintLength + getContextTextSize(Args);
+            const auto  TextOffset   = Align(sizeof(entry) + ArgsSize) + info_v;
+            const auto  Size         = Align(TextOffset + TextCapacity + 1);
+            if (Size > size_v || TextCapacity > 0xffff) return nullptr;
+
+            // Entries never wrap around the end of the buffer
+            if ((m_Head % size_v) + Size > size_v) m_Head += size_v - (m_Head % size_v);
+
+            auto& Entry = *new (&m_Data[m_Head % size_v]) entry
+            { m_iNewest
+            , pMessage
+            , static_cast<std::uint16_t>(Size)
+            , static_cast<std::uint16_t>(ArgsSize)
+            , static_cast<std::uint16_t>(TextOffset)
+            , static_cast<std::uint16_t>(TextCapacity)
+            , false
+            };
+            WriteContext(Args, { reinterpret_cast<std::byte*>(&Entry + 1), ArgsSize });
+
+            m_iNewest = m_Head + 1;
+            m_Head   += Size;
+            return &Entry;
+        }
+    }
+
+    //------------------------------------------------------------------------------------
+    // Latest entry of the error of this thread that has not been overwritten yet
+    inline context_arena::entry* context_arena::Find(const char* pMessage) noexcept
+    {
+        if constexpr (size_v == 0) return nullptr;
+        else
+        {
+            for (auto i = m_iNewest; i != none_v && m_Head - (i - 1) <= size_v; )
+            {
+                auto& Entry = *reinterpret_cast<entry*>(&m_Data[(i - 1) % size_v]);
+                if (Entry.m_pMessage == pMessage) return &Entry;
+                i = Entry.m_iPrev;
+            }
+            return nullptr;
+        }
+    }
+
+    //------------------------------------------------------------------------------------
+
+    thread_local inline context_arena g_ContextArena = {};
+
+    //------------------------------------------------------------------------------------
+    // Text of an error, formatted with its arguments when this thread still has them
+    inline const char* getContextText(const char* pMessage) noexcept
+    {
+        if (pMessage && GetInfo(pMessage).m_nArgs)
+        {
+            if (auto* pEntry = g_ContextArena.Find(pMessage); pEntry) return pEntry->getText();
+        }
+        return pMessage;
+    }
+
+    //------------------------------------------------------------------------------------
+    // STACK CAPTURE
+    //------------------------------------------------------------------------------------
+
+#if defined(_MSC_VER)
+    extern "C" __declspec(dllimport) unsigned short __stdcall RtlCaptureStackBackTrace(unsigned long FramesToSkip, unsigned long FramesToCapture, void** pBackTrace, unsigned long* pHash);
+
+    __declspec(noinline) inline std::uint32_t WalkStack(std::span<void*> Frames) noexcept
+    {
+        return RtlCaptureStackBackTrace(1, static_cast<unsigned long>(Frames.size()), Frames.data(), nullptr);
+    }
+#else
+    //------------------------------------------------------------------------------------
+    // Follows the frame pointers from the caller of this function, it must not be inlined so that
+    // its own frame starts the walk. A frame without a frame pointer leaves garbage in the chain,
+    // the walk stops at the first link that does not go up the stack by a sane amount
+    [[gnu::noinline]] inline std::uint32_t WalkStack(std::span<void*> Frames) noexcept
+    {
+        auto*         pFrame = static_cast<void* const*>(__builtin_frame_address(0));
+        std::uint32_t n      = 0;
+
+        while (n < Frames.size())
+        {
+            // { previous frame pointer, return address } on x86-64 and AArch64
+            if ((Frames[n] = pFrame[1]) == nullptr) break;
+            ++n;
+
+            auto* pNext = static_cast<void* const*>(pFrame[0]);
+            const auto Here = reinterpret_cast<std::uintptr_t>(pFrame);
+            const auto Next = reinterpret_cast<std::uintptr_t>(pNext);
+            if (Next <= Here || Next - Here > stack_pool::max_frame_v || (Next & (alignof(void*) - 1))) break;
+            pFrame = pNext;
+        }
+        return n;
+    }
+#endif
+
+    //------------------------------------------------------------------------------------
+
+    inline void stack_pool::Capture(const char* pMessage) noexcept
+    {
+        auto& Slot = m_Slots[m_Count++ % slots_v];
+        Slot.m_pMessage = pMessage;
+        Slot.m_Depth    = WalkStack(Slot.m_Frames);
+    }
+
+    //------------------------------------------------------------------------------------
+    // Latest stack of the error that has not been overwritten yet
+    inline const stack_pool::slot* stack_pool::Find(const char* pMessage) const noexcept
+    {
+        const auto nSlots = std::min<std::size_t>(m_Count, slots_v);
+        for (std::size_t i = 1; i <= nSlots; ++i)
+        {
+            const auto& Slot = m_Slots[(m_Count - i) % slots_v];
+            if (Slot.m_pMessage == pMessage) return &Slot;
+        }
+        return nullptr;
+    }
+
+    //------------------------------------------------------------------------------------
+
+#if XERR_STACK_DEPTH
+    thread_local inline stack_pool g_StackPool = {};
+#endif
+
+    //------------------------------------------------------------------------------------
+    // CATALOG
+    //------------------------------------------------------------------------------------
+
+    inline catalog_entry::catalog_entry(std::uint64_t ID, std::uint64_t TypeHash, const char* pMessage, const char* pStateName) noexcept
+        : m_ID(ID), m_TypeHash(TypeHash), m_pMessage(pMessage), m_pStateName(pStateName)
+    {
+        xerr::m_Catalog.Register(*this);
+    }
+
+    //------------------------------------------------------------------------------------
+    // State and "message|hint" of two sites, the part of the site ID that is not the enum
+    inline bool isSameMessage(const char* pA, const char* pB) noexcept
+    {
+        if (pA == pB) return true;
+
+        const auto& InfoA = GetInfo(pA);
+        const auto& InfoB = GetInfo(pB);
+        return InfoA.m_State      == InfoB.m_State
+            && InfoA.m_HintOffset == InfoB.m_HintOffset
+            && InfoA.m_HintLength == InfoB.m_HintLength
+            && std::memcmp(pA, pB, InfoA.m_HintOffset + InfoA.m_HintLength) == 0;
+    }
+
+    //------------------------------------------------------------------------------------
+    // Two entries with the same ID must be the same site: same enum, state and "message|hint".
+    // The enum is compared by the hash of its name, m_TypeGUID depends on the compiler
+    inline bool catalog::isSameSite(const catalog_entry& A, const catalog_entry& B) noexcept
+    {
+        return A.m_TypeHash == B.m_TypeHash && isSameMessage(A.m_pMessage, B.m_pMessage);
+    }
+
+    //------------------------------------------------------------------------------------
+    // Used by xerr::operator == for the IDs that collided, the site ID alone no longer tells
+    // sites apart. A site missing from the catalog is the copy of a known site in another
+    // shared object, without its entry the enum is compared by the UID in the headers
+    inline bool catalog::isSameSite(const char* pA, const char* pB) const noexcept
+    {
+        const auto* pEntryA = FindSite(pA);
+        const auto* pEntryB = FindSite(pB);
+        if (pEntryA && pEntryB) return pEntryA->m_TypeHash == pEntryB->m_TypeHash && isSameMessage(pA, pB);
+        return GetInfo(pA).m_TypeGUID == GetInfo(pB).m_TypeGUID && isSameMessage(pA, pB);
+    }
+
+    //------------------------------------------------------------------------------------
+    // The catalog is constant initialized so it is ready before any entry registers
+    inline void catalog::Register(catalog_entry& Entry) noexcept
+    {
+        // A second entry of a known ID is the same site in another shared object. Anything else
+        // would make site IDs ambiguous: the new site is refused (Find keeps returning the first)
+        // and counted, and the first is flagged so xerr::operator == compares messages for that ID
+        auto Collided = [&](const catalog_entry& Known, catalog_entry& New) noexcept
+        {
+            if (isSameSite(Known, New)) return;
+
+            New.m_pNext = m_pRefused.load(std::memory_order_relaxed);
+            while (!m_pRefused.compare_exchange_weak(New.m_pNext, &New, std::memory_order_release, std::memory_order_relaxed)) {}
+            Known.m_bCollided.store(true, std::memory_order_release);
+            m_nCollisions.fetch_add(1, std::memory_order_release);
+            assert(false && "xerr site ID collision, change one of the messages");
+        };
+
+        if constexpr (index_size_v != 0)
+        {
+            for (std::size_t i = 0; i < index_size_v; ++i)
+            {
+                auto&          Slot      = m_Index[(Entry.m_ID + i) & (index_size_v - 1)];
+                catalog_entry* pExpected = nullptr;
+                if (Slot.compare_exchange_strong(pExpected, &Entry, std::memory_order_acq_rel)) break;
+
+                // Already known (the same site compiled into another shared object)
+                if (pExpected->m_ID == Entry.m_ID) return Collided(*pExpected, Entry);
+            }
+        }
+        else
+        {
+            if (auto* pFound = Find(Entry.m_ID); pFound) return Collided(*pFound, Entry);
+        }
+
+        Entry.m_pNext = m_pHead.load(std::memory_order_relaxed);
+        while (!m_pHead.compare_exchange_weak(Entry.m_pNext, &Entry, std::memory_order_release, std::memory_order_relaxed)) {}
+        m_Count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    //------------------------------------------------------------------------------------
+
+    inline const catalog_entry* catalog::Find(std::uint64_t ID) const noexcept
+    {
+        if constexpr (index_size_v != 0)
+        {
+            for (std::size_t i = 0; i < index_size_v; ++i)
+            {
+                const auto* pEntry = m_Index[(ID + i) & (index_size_v - 1)].load(std::memory_order_acquire);
+                if (pEntry == nullptr || pEntry->m_ID == ID) return pEntry;
+            }
+        }
+
+        // The table is full (or disabled), fall back to the list
+        for (auto* pEntry = m_pHead.load(std::memory_order_acquire); pEntry; pEntry = pEntry->m_pNext)
+            if (pEntry->m_ID == ID) return pEntry;
+
+        return nullptr;
+    }
+
+    //------------------------------------------------------------------------------------
+
+    inline const catalog_entry* catalog::FindSite(const char* pMessage) const noexcept
+    {
+        for (auto* pEntry = m_pHead.load(std::memory_order_acquire); pEntry; pEntry = pEntry->m_pNext)
+            if (pEntry->m_pMessage == pMessage) return pEntry;
+
+        for (auto* pEntry = m_pRefused.load(std::memory_order_acquire); pEntry; pEntry = pEntry->m_pNext)
+            if (pEntry->m_pMessage == pMessage) return pEntry;
+
+        return nullptr;
+    }
+
+    //------------------------------------------------------------------------------------
+
+    template< typename T_CALLBACK > inline
+    void catalog::ForEach(T_CALLBACK&& Callback) const noexcept
+    {
+        for (auto* pEntry = m_pHead.load(std::memory_order_acquire); pEntry; pEntry = pEntry->m_pNext)
+            Callback(*pEntry);
+    }
+
+    //------------------------------------------------------------------------------------
+    // STATE NAME REGISTRY
+    //------------------------------------------------------------------------------------
+
+    inline state_name_entry::state_name_entry(std::uint32_t UID, const char* pNames, std::uint16_t Size, const std::uint16_t* pOffset, std::uint16_t Count) noexcept
+        : m_UID(UID), m_Size(Size), m_Count(Count), m_pNames(pNames), m_pOffset(pOffset)
+    {
+        xerr::m_StateNames.Register(*this);
+    }
+
+    //------------------------------------------------------------------------------------
+
+    inline std::string_view state_name_entry::getName(std::uint8_t State) const noexcept
+    {
+        if (State >= m_Count || m_pOffset[State] == 0xffff) return {};
+        return m_pNames + m_pOffset[State];
+    }
+
+    //------------------------------------------------------------------------------------
+    // Same as the catalog: the table of an enum compiled into several shared objects registers once
+    inline void state_name_registry::Register(state_name_entry& Entry) noexcept
+    {
+        auto isSame = [](const state_name_entry& A, const state_name_entry& B) noexcept
+        {
+            return A.m_Size == B.m_Size && A.m_Count == B.m_Count
+                && std::memcmp(A.m_pNames,  B.m_pNames,  A.m_Size)                             == 0
+                && std::memcmp(A.m_pOffset, B.m_pOffset, A.m_Count * sizeof(std::uint16_t))   == 0;
+        };
+
+        for (std::size_t i = 0; i < index_size_v; ++i)
+        {
+            auto&             Slot      = m_Index[(Entry.m_UID + i) & (index_size_v - 1)];
+            state_name_entry* pExpected = nullptr;
+            if (Slot.compare_exchange_strong(pExpected, &Entry, std::memory_order_acq_rel)) break;
+
+            if (pExpected->m_UID == Entry.m_UID)
+            {
+                // The first enum keeps the UID, the names of the other are not reachable at runtime
+                if (isSame(*pExpected, Entry) == false) m_nCollisions.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+        }
+
+        Entry.m_pNext = m_pHead.load(std::memory_order_relaxed);
+        while (!m_pHead.compare_exchange_weak(Entry.m_pNext, &Entry, std::memory_order_release, std::memory_order_relaxed)) {}
+    }
+
+    //------------------------------------------------------------------------------------
+
+    inline const state_name_entry* state_name_registry::Find(std::uint32_t UID) const noexcept
+    {
+        for (std::size_t i = 0; i < index_size_v; ++i)
+        {
+            const auto* pEntry = m_Index[(UID + i) & (index_size_v - 1)].load(std::memory_order_acquire);
+            if (pEntry == nullptr || pEntry->m_UID == UID) return pEntry;
+        }
+
+        // More enums than slots, fall back to the list
+        for (auto* pEntry = m_pHead.load(std::memory_order_acquire); pEntry; pEntry = pEntry->m_pNext)
+            if (pEntry->m_UID == UID) return pEntry;
+
+        return nullptr;
+    }
+
+    //------------------------------------------------------------------------------------
+
+    template< typename T_STATE_ENUM >
+    inline state_name_entry state_name_entry_v
+    { uid_v<T_STATE_ENUM>
+    , state_names<T_STATE_ENUM>::table_v.m_Names.data(), static_cast<std::uint16_t>(state_names<T_STATE_ENUM>::chars_v)
+    , state_names<T_STATE_ENUM>::table_v.m_Offset.data(), static_cast<std::uint16_t>(state_names<T_STATE_ENUM>::count_v)
+    };
+
+    //------------------------------------------------------------------------------------
+
+    template <string_literal T_STR_V, auto T_STATE_V>
+    inline catalog_entry catalog_v{ data_v<T_STR_V, T_STATE_V>.m_SiteID, details::getTypeNameHash<decltype(T_STATE_V)>(details::fnv1a_offset_v), data_v<T_STR_V, T_STATE_V>.m_Message, getStateName<T_STATE_V>() };
+
+    //------------------------------------------------------------------------------------
+    // Hooks of the subsystems compiled in by their XERR_ macro, their headers define them
+    // (xerr.h includes those at the end)
+#if XERR_REPORT_RATE
+    template< string_literal T_STR_V, auto T_STATE_V >
+    inline site_limiter&    getSiteLimiter  (void)                                      noexcept;   // xerr_report_limits.h
+    inline bool             AllowReport     ( site_limiter& Limiter )                   noexcept;   // xerr_report_limits.h
+#endif
+#if XERR_SITE_STATS
+    template< string_literal T_STR_V, auto T_STATE_V >
+    inline void             HitSite         (void)                                      noexcept;   // xerr_site_stats.h
+#endif
+#if XERR_FLIGHT_RECORDER
+    inline void             RecordFlight    ( const char* pMessage, std::uint32_t Line ) noexcept;  // xerr_flight_recorder.h
+#endif
+
+    //------------------------------------------------------------------------------------
+    // Every error and LogMessage goes through here on its way to the sink or the callback.
+    // States filtered by xerr::report_policy compile to nothing, the rest pay one relaxed
+    // load of the runtime mask and only when someone is listening
+    template< auto T_STATE_V >
+    inline void Report(const char* pMessage, std::string_view Message, const xerr::location<T_STATE_V>& loc, context_arena::entry* pContext = nullptr, site_limiter* pLimiter = nullptr) noexcept
+    {
+        if constexpr (xerr::is_reported_v<T_STATE_V>)
+        {
+            // Naming the table of the enum gets it registered at static initialization time
+            (void)state_name_entry_v<decltype(T_STATE_V)>;
+
+            auto* pSinkPush = xerr::m_pSinkPush.load(std::memory_order_relaxed);
+            if (pSinkPush == nullptr && xerr::m_pCallback == nullptr) return;
+
+            constexpr std::uint64_t StateBit = std::uint64_t{ 1 } << (static_cast<std::uint8_t>(T_STATE_V) & 63);
+            if ((xerr::m_ReportMask.load(std::memory_order_relaxed) & StateBit) == 0) return;
+
+#if XERR_REPORT_RATE
+            if (pLimiter && AllowReport(*pLimiter) == false) return;
+#else
+            (void)pLimiter;
+#endif
+
+            if (pSinkPush)
+            {
+                // The sink gets the serialized arguments (when they fit), it formats them when it drains
+                std::string_view Text = pMessage ? std::string_view{} : Message;
+                std::byte        Args[sink_text_size_v];
+                if (pContext) Text = { reinterpret_cast<const char*>(Args), CopyContext(pContext->getArgs(), Args) };
+
+                pSinkPush(getStateValueName<T_STATE_V>(), static_cast<std::uint8_t>(T_STATE_V), pMessage, Text, loc.file_name(), loc.line());
+            }
+            else
+            {
+                if (pContext)
+                {
+                    const auto* pText = pContext->getText();
+                    const auto& Info  = GetInfo(pText);
+                    Message = { pText, static_cast<std::size_t>(Info.m_HintOffset + Info.m_HintLength) };
+                }
+
+                xerr::m_pCallback(getStateValueName<T_STATE_V>(), static_cast<std::uint8_t>(T_STATE_V), Message, loc.line(), loc.file_name());
+            }
+        }
+    }
+
+    //------------------------------------------------------------------------------------
+
+    template< auto T_STATE_V, string_literal T_STR_V >
+    inline void ReportError(const xerr::location<T_STATE_V>& loc, context_arena::entry* pContext = nullptr) noexcept
+    {
+        constexpr auto& Data = data_v<T_STR_V, T_STATE_V>;
+
+        // Naming the entry is enough to get it registered at static initialization time
+        (void)catalog_v<T_STR_V, T_STATE_V>;
+
+#if XERR_STACK_DEPTH
+        g_StackPool.Capture(Data.m_Message);
+#endif
+#if XERR_FLIGHT_RECORDER
+        if constexpr (xerr::is_reported_v<T_STATE_V>) RecordFlight(Data.m_Message, loc.line());
+        else                                          RecordFlight(Data.m_Message, 0);
+#endif
+#if XERR_SITE_STATS
+        HitSite<T_STR_V, T_STATE_V>();
+#endif
+#if XERR_REPORT_RATE
+        Report<T_STATE_V>(Data.m_Message, { Data.m_Message, T_STR_V.m_Value.size() - 1 }, loc, pContext, &getSiteLimiter<T_STR_V, T_STATE_V>());
+#else
+        Report<T_STATE_V>(Data.m_Message, { Data.m_Message, T_STR_V.m_Value.size() - 1 }, loc, pContext);
+#endif
+    }
+
+    //------------------------------------------------------------------------------------
+    // FORMAT
+    //------------------------------------------------------------------------------------
+
+    // Output iterator over a fixed buffer, what does not fit is counted but dropped
+    struct buffer_writer
+    {
+        using difference_type = std::ptrdiff_t;
+
+        constexpr buffer_writer&    operator *  (void)              noexcept { return *this; }
+        constexpr buffer_writer&    operator ++ (void)              noexcept { ++m_Count; return *this; }
+        constexpr buffer_writer     operator ++ (int)               noexcept { auto Old = *this; ++m_Count; return Old; }
+        constexpr buffer_writer&    operator =  (char C)            noexcept { if (m_Count < m_Size) m_pData[m_Count] = C; return *this; }
+        inline    void              Write       (std::string_view Text) noexcept;
+
+        char*                       m_pData;
+        std::size_t                 m_Size;
+        std::size_t                 m_Count;
+    };
+
+    //------------------------------------------------------------------------------------
+
+    inline void buffer_writer::Write(std::string_view Text) noexcept
+    {
+        if (m_Count < m_Size) std::copy_n(Text.data(), std::min(Text.size(), m_Size - m_Count), &m_pData[m_Count]);
+        m_Count += Text.size();
+    }
+
+    //------------------------------------------------------------------------------------
+
+    template< typename T_OUT > inline
+    void Put(T_OUT& Out, std::string_view Text) noexcept
+    {
+        if constexpr (std::is_same_v<T_OUT, buffer_writer>) Out.Write(Text);
+        else                                                for (const char C : Text) *Out++ = C;
+    }
+
+    //------------------------------------------------------------------------------------
+
+    template< typename T_OUT > inline
+    void PutNumber(T_OUT& Out, std::uint64_t Value, int Base = 10, std::size_t MinDigits = 0) noexcept
+    {
+        char       Digits[24];
+        const auto Length = static_cast<std::size_t>(std::to_chars(Digits, std::end(Digits), Value, Base).ptr - Digits);
+        for (auto i = Length; i < MinDigits; ++i) *Out++ = '0';
+        Put(Out, { Digits, Length });
+    }
+
+    //------------------------------------------------------------------------------------
+
+    template< typename T_OUT > inline
+    void PutJsonString(T_OUT& Out, std::string_view Text) noexcept
+    {
+        constexpr const char* pHex      = "0123456789abcdef";
+        constexpr auto        isSpecial = [](char C) noexcept { return C == '"' || C == '\\' || static_cast<unsigned char>(C) < 0x20; };
+
+        *Out++ = '"';
+        for (auto It = Text.begin(); It != Text.end(); )
+        {
+            // Runs of plain characters go out in one piece
+            const auto End = std::find_if(It, Text.end(), isSpecial);
+            Put(Out, { It, End });
+            if (End == Text.end()) break;
+
+            const char C = *End;
+            if (C == '"' || C == '\\') { *Out++ = '\\'; *Out++ = C; }
+            else                        { Put(Out, "\\u00"); *Out++ = pHex[(C >> 4) & 0xf]; *Out++ = pHex[C & 0xf]; }
+            It = End + 1;
+        }
+        *Out++ = '"';
+    }
+
+    //------------------------------------------------------------------------------------
+    // Name of the state from the catalog, or "state N" for states without one (see xerr::report_policy)
+    template< typename T_OUT > inline
+    void PutState(T_OUT& Out, xerr Link, bool bJson) noexcept
+    {
+        if (const auto Name = Link.getStateName(); Name.empty() == false)
+        {
+            if (bJson) PutJsonString(Out, Name);
+            else       Put(Out, Name);
+        }
+        else
+        {
+            Put(Out, bJson ? "\"state " : "state ");
+            PutNumber(Out, static_cast<std::uint8_t>(Link.m_pMessage[-1]));
+            if (bJson) *Out++ = '"';
+        }
+    }
+
+    //------------------------------------------------------------------------------------
+
+    template< typename T_OUT > inline
+    T_OUT FormatChain(xerr Error, T_OUT Out, xerr::format_style Style, bool bSite) noexcept
+    {
+        const bool bJson = Style == xerr::format_style::JSON;
+        bool       bFirst = true;
+
+        if (bJson)              *Out++ = '[';
+        else if (!Error)        Put(Out, "OK");
+
+        Error.ForEachInChainBackwards([&](xerr Link)
+        {
+            const auto Hint = Link.getHint();
+
+            if (bJson)
+            {
+                if (bFirst == false) *Out++ = ',';
+                Put(Out, "{\"state\":");
+                PutState(Out, Link, true);
+                Put(Out, ",\"code\":");
+                PutNumber(Out, static_cast<std::uint8_t>(Link.m_pMessage[-1]));
+                Put(Out, ",\"message\":");
+                PutJsonString(Out, Link.getMessage());
+                Put(Out, ",\"hint\":");
+                PutJsonString(Out, Hint);
+                if (bSite)
+                {
+                    Put(Out, ",\"site\":\"0x");
+                    PutNumber(Out, Link.getSiteID(), 16, 16);
+                    *Out++ = '"';
+                }
+                *Out++ = '}';
+            }
+            else
+            {
+                if (bFirst == false) Put(Out, Style == xerr::format_style::LINE ? " <- " : "\n  caused by ");
+                PutState(Out, Link, false);
+                Put(Out, ": ");
+                Put(Out, Link.getMessage());
+                if (Hint.empty() == false)
+                {
+                    Put(Out, " (");
+                    Put(Out, Hint);
+                    *Out++ = ')';
+                }
+                if (bSite)
+                {
+                    Put(Out, " [site 0x");
+                    PutNumber(Out, Link.getSiteID(), 16, 16);
+                    *Out++ = ']';
+                }
+            }
+            bFirst = false;
+        });
+
+        if (bJson) *Out++ = ']';
+        return Out;
+    }
+
+    //------------------------------------------------------------------------------------
+    // MATCH
+    //------------------------------------------------------------------------------------
+
+    template< typename T_STATE_ENUM >
+    consteval bool hasDefaultStates(void) noexcept
+    {
+        if constexpr (requires { T_STATE_ENUM::OK; T_STATE_ENUM::FAILURE; })
+            return static_cast<std::uint32_t>(T_STATE_ENUM::OK) == 0 && static_cast<std::uint32_t>(T_STATE_ENUM::FAILURE) == 1;
+        else
+            return false;
+    }
+
+    //------------------------------------------------------------------------------------
+    // Key of a handler, the states of an enum sort before its any_state_v
+    consteval std::uint64_t MatchKey(std::uint32_t UID, std::uint32_t State) noexcept
+    {
+        return (std::uint64_t{ UID } << 16) | State;
+    }
+
+    //------------------------------------------------------------------------------------
+
+    template< typename T_STATE_ENUM, std::uint32_t T_STATE_V, typename T_CALLBACK >
+    struct match_case
+    {
+        static_assert(sizeof(T_STATE_ENUM) == 1, "xerr states must be one byte enums");
+        static_assert(hasDefaultStates<T_STATE_ENUM>(), "xerr::on needs an enum with OK = 0 and FAILURE = 1, like xerr::default_states");
+
+        constexpr static bool          any_v = T_STATE_V == any_state_v;
+        constexpr static std::uint64_t key_v = MatchKey(uid_v<T_STATE_ENUM>, T_STATE_V);
+
+        // A handler passed as const gets called as const, so it needs a const call operator
+        template< typename T_SELF >
+        inline static void Call(T_SELF& Self, xerr Error) noexcept
+        {
+            using callback = decltype((Self.m_Callback));
+
+            const auto State = static_cast<T_STATE_ENUM>(Error.m_pMessage[-1]);
+            if      constexpr (any_v && std::invocable<callback, xerr, T_STATE_ENUM>) Self.m_Callback(Error, State);
+            else if constexpr (any_v && std::invocable<callback, T_STATE_ENUM>)       Self.m_Callback(State);
+            else if constexpr (std::invocable<callback, xerr>)                        Self.m_Callback(Error);
+            else                                                                      Self.m_Callback();
+        }
+
+        T_CALLBACK      m_Callback;
+    };
+
+    //------------------------------------------------------------------------------------
+
+    template< typename T_CALLBACK >
+    struct match_otherwise
+    {
+        template< typename T_SELF >
+        inline static void Call(T_SELF& Self, xerr Error) noexcept
+        {
+            if constexpr (std::invocable<decltype((Self.m_Callback)), xerr>) Self.m_Callback(Error);
+            else                                                            Self.m_Callback();
+        }
+
+        T_CALLBACK      m_Callback;
+    };
+
+    template< typename T >                  constexpr bool is_otherwise_v                       = false;
+    template< typename T_CALLBACK >         constexpr bool is_otherwise_v<match_otherwise<T_CALLBACK>> = true;
+
+    //------------------------------------------------------------------------------------
+    // Sorted keys of a set of handlers and the jump table to them, both built at compile time.
+    // The handlers keep their constness, the jump table casts back to exactly what was passed
+    template< typename... T_CASES >
+    struct match_table
+    {
+        constexpr static std::size_t count_v     = sizeof...(T_CASES);
+        constexpr static std::size_t n_keyed_v   = ((is_otherwise_v<std::remove_cv_t<T_CASES>> ? 0 : 1) + ... + 0);
+        constexpr static std::size_t otherwise_v = []() consteval noexcept
+        {
+            std::size_t i = 0, Index = count_v;
+            ((is_otherwise_v<std::remove_cv_t<T_CASES>> ? (Index = i, ++i) : ++i), ...);
+            return Index;
+        }();
+
+        static_assert(count_v - n_keyed_v <= 1, "xerr::Match takes at most one xerr::otherwise");
+
+        struct entry
+        {
+            std::uint64_t   m_Key;
+            std::uint32_t   m_Index;                // Position of the handler in the arguments
+        };
+
+        constexpr static auto entries_v = []() consteval noexcept
+        {
+            std::array<entry, n_keyed_v> Entries{};
+            std::size_t i = 0, n = 0;
+            auto Add = [&]<typename T>() consteval
+            {
+                if constexpr (is_otherwise_v<std::remove_cv_t<T>> == false) Entries[n++] = { T::key_v, static_cast<std::uint32_t>(i) };
+                ++i;
+            };
+            (Add.template operator()<T_CASES>(), ...);
+            std::sort(Entries.begin(), Entries.end(), [](const entry& A, const entry& B) { return A.m_Key < B.m_Key; });
+            return Entries;
+        }();
+
+        static_assert([]() consteval noexcept
+        {
+            for (std::size_t i = 1; i < n_keyed_v; ++i) if (entries_v[i - 1].m_Key == entries_v[i].m_Key) return false;
+            return true;
+        }(), "xerr::Match has two handlers for the same state");
+
+        using fn_call = void(xerr Error, const void* const* pCases) noexcept;
+
+        template< std::size_t T_INDEX_V, typename T_CASE >
+        static void Call(xerr Error, const void* const* pCases) noexcept
+        {
+            // Only takes back the const Match added, a const handler stays const
+            T_CASE::Call(*const_cast<T_CASE*>(static_cast<const T_CASE*>(pCases[T_INDEX_V])), Error);
+        }
+
+        constexpr static auto jump_v = []<std::size_t... T_INDEX_V>(std::index_sequence<T_INDEX_V...>) consteval noexcept
+        {
+            return std::array<fn_call*, count_v>{ &Call<T_INDEX_V, T_CASES>... };
+        }(std::make_index_sequence<count_v>{});
+
+        // Index of the handler of a key, count_v for none
+        static std::size_t Find(std::uint64_t Key) noexcept
+        {
+            constexpr auto Less = [](const entry& E, std::uint64_t K) noexcept { return E.m_Key < K; };
+
+            auto It = std::lower_bound(entries_v.begin(), entries_v.end(), Key, Less);
+            if (It != entries_v.end() && It->m_Key == Key) return It->m_Index;
+
+            // Not this state, maybe the whole enum. It can only be further down
+            const auto AnyKey = (Key & ~std::uint64_t{ 0xffff }) | any_state_v;
+            It = std::lower_bound(It, entries_v.end(), AnyKey, Less);
+            if (It != entries_v.end() && It->m_Key == AnyKey) return It->m_Index;
+
+            return otherwise_v;
+        }
+    };
+}
+
+//------------------------------------------------------------------------------------
+
+constexpr
+xerr::operator bool(void) const noexcept
+{
+    return !!m_pMessage;
+}
+
+//------------------------------------------------------------------------------------
+
+inline
+void xerr::clear(void) noexcept
+{
+    m_pMessage = nullptr;
+    m_ChainPool.Free(xerr_details::g_iCurChain, xerr_details::g_iCurTail);
+}
+
+//------------------------------------------------------------------------------------
+// From the name table of the enum, or the catalog when another enum took its UID or the state is
+// past the scanned values. Empty when the state is not reported (see xerr::report_policy) or has no name
+inline
+std::string_view xerr::getStateName(void) const noexcept
+{
+    if (m_pMessage == nullptr) return {};
+
+    if (const auto* pNames = m_StateNames.Find(getStateUID()); pNames)
+        if (const auto Name = pNames->getName(static_cast<std::uint8_t>(m_pMessage[-1])); Name.empty() == false) return Name;
+    if (const auto* pEntry = m_Catalog.Find(getSiteID()); pEntry && pEntry->m_pStateName) return pEntry->m_pStateName;
+    return {};
+}
+
+//------------------------------------------------------------------------------------
+
+inline
+bool xerr::operator == (const xerr& Other) const noexcept
+{
+    if (m_pMessage == Other.m_pMessage) return true;
+    if (m_pMessage == nullptr || Other.m_pMessage == nullptr) return false;
+    if (getSiteID() != Other.getSiteID()) return false;
+
+    // Two different sites share this ID, compare what the ID was made of
+    if (m_Catalog.m_nCollisions.load(std::memory_order_acquire))
+        if (const auto* pEntry = m_Catalog.Find(getSiteID()); pEntry && pEntry->m_bCollided.load(std::memory_order_acquire))
+            return m_Catalog.isSameSite(m_pMessage, Other.m_pMessage);
+    return true;
+}
+//------------------------------------------------------------------------------------
+
+constexpr
+std::uint32_t xerr::getStateUID(void) const noexcept
+{
+    return m_pMessage ? reinterpret_cast<const std::uint32_t&>(m_pMessage[-5]) : 0;
+}
+
+//------------------------------------------------------------------------------------
+
+inline
+std::uint64_t xerr::getSiteID(void) const noexcept
+{
+    return m_pMessage ? xerr_details::GetInfo(m_pMessage).m_SiteID : 0;
+}
+
+//------------------------------------------------------------------------------------
+
+template <auto T_STATE_V, xerr_details::string_literal T_STR_V> consteval
+std::uint64_t xerr::fromSiteID(void) noexcept requires (std::is_enum_v<decltype(T_STATE_V)>)
+{
+    return xerr_details::create_site_id<T_STR_V, T_STATE_V>();
+}
+
+//------------------------------------------------------------------------------------
+
+template< typename T_STATE_ENUM > consteval
+std::uint32_t xerr::fromStateUID(void) noexcept requires (std::is_enum_v<T_STATE_ENUM>)
+{
+    return xerr_details::uid_v<T_STATE_ENUM>;
+}
+
+//------------------------------------------------------------------------------------
+
+template< typename T_STATE_ENUM > constexpr
+bool xerr::isState(void) const noexcept requires (std::is_enum_v<T_STATE_ENUM>)
+{
+    return m_pMessage == nullptr || xerr_details::uid_v<T_STATE_ENUM> == getStateUID();
+}
+
+//------------------------------------------------------------------------------------
+
+constexpr
+bool xerr::hasChain(void) const noexcept
+{
+    return m_pMessage != nullptr && xerr_details::g_iCurChain != -1;
+}
+
+//------------------------------------------------------------------------------------
+
+inline
+std::string_view xerr::getMessageFromString(const char* pMessage) noexcept
+{
+    if (pMessage == nullptr) return {};
+    return { pMessage, xerr_details::GetInfo(pMessage).m_MessageLength };
+}
+
+//------------------------------------------------------------------------------------
+
+inline
+std::string_view xerr::getMessage(void) const noexcept
+{
+    return getMessageFromString(xerr_details::getContextText(m_pMessage));
+}
+
+//------------------------------------------------------------------------------------
+inline
+std::string_view xerr::getMessageFromMsg(std::string_view msg) noexcept
+{
+    if (msg.empty()) return {};
+
+    std::size_t i   = 0;
+    const auto  end = msg.length();
+    while ( i < end && msg[i] != '|') ++i;
+
+    return { msg.begin(), msg.begin() + i};
+}
+
+//------------------------------------------------------------------------------------
+inline
+std::string_view xerr::getHintFromMsg(std::string_view msg) noexcept
+{
+    if (msg.empty()) return {};
+
+    std::size_t iStart  = 0;
+    const auto  end     = msg.length();
+    while (iStart < end && msg[iStart] != '|') ++iStart;
+
+    if (msg[iStart] != '|') return {};
+
+    return { msg.begin() + iStart, msg.end()};
+}
+
+//------------------------------------------------------------------------------------
+
+inline
+std::string_view xerr::getHintFromString(const char* pMessage) noexcept
+{
+    if (pMessage == nullptr) return {};
+    const auto& Info = xerr_details::GetInfo(pMessage);
+    return { pMessage + Info.m_HintOffset, Info.m_HintLength };
+}
+
+//------------------------------------------------------------------------------------
+
+inline
+std::string_view xerr::getHint(void) const noexcept
+{
+    return getHintFromString(xerr_details::getContextText(m_pMessage));
+}
+
+//------------------------------------------------------------------------------------
+
+template< typename T_CALLBACK> inline
+void xerr::ForEachInChain(T_CALLBACK&& Callback) const noexcept requires std::invocable<T_CALLBACK, xerr>
+{
+    if( m_pMessage == nullptr ) return;
+
+    if(xerr_details::g_iCurChain == -1)
+    {
+        Callback(*this);
+    }
+    else
+    {
+        for (auto i = xerr_details::g_iCurTail; i != -1; i = m_ChainPool[i].m_iPrev)
+            Callback(xerr{ m_ChainPool.getError(i) });
+    }
+}
+
+//------------------------------------------------------------------------------------
+
+template< typename T_CALLBACK> inline
+void xerr::ForEachInChainBackwards(T_CALLBACK&& Callback) const noexcept requires std::invocable<T_CALLBACK, xerr>
+{
+    if (m_pMessage == nullptr) return;
+
+    if (xerr_details::g_iCurChain == -1)
+    {
+        Callback(*this);
+    }
+    else
+    {
+        for (auto i = xerr_details::g_iCurChain; i != -1; i = m_ChainPool[i].m_iNext)
+            Callback(xerr{ m_ChainPool.getError(i) });
+    }
+}
+
+//------------------------------------------------------------------------------------
+// OWNED CHAINS
+//------------------------------------------------------------------------------------
+
+inline
+xerr::owned::owned(xerr Error) noexcept
+    : m_pMessage{ Error.m_pMessage }
+{
+    // Only take the thread chain if it is the chain of this error
+    if (Error.m_pMessage && xerr_details::g_iCurChain != -1 && m_ChainPool.getError(xerr_details::g_iCurChain) == Error.m_pMessage)
+    {
+        m_iHead = std::exchange(xerr_details::g_iCurChain, index{ -1 });
+        m_iTail = std::exchange(xerr_details::g_iCurTail,  index{ -1 });
+    }
+}
+
+//------------------------------------------------------------------------------------
+
+inline
+xerr::owned::owned(owned&& Other) noexcept
+    : m_pMessage{ std::exchange(Other.m_pMessage, nullptr) }
+    , m_iHead{ std::exchange(Other.m_iHead, index{ -1 }) }
+    , m_iTail{ std::exchange(Other.m_iTail, index{ -1 }) }
+{
+}
+
+//------------------------------------------------------------------------------------
+
+inline
+xerr::owned::~owned(void) noexcept
+{
+    m_ChainPool.Free(m_iHead, m_iTail);
+}
+
+//------------------------------------------------------------------------------------
+
+inline
+xerr::owned& xerr::owned::operator = (owned&& Other) noexcept
+{
+    if (this != &Other)
+    {
+        m_ChainPool.Free(m_iHead, m_iTail);
+        m_pMessage = std::exchange(Other.m_pMessage, nullptr);
+        m_iHead = std::exchange(Other.m_iHead, index{ -1 });
+        m_iTail = std::exchange(Other.m_iTail, index{ -1 });
+    }
+    return *this;
+}
+
+//------------------------------------------------------------------------------------
+
+inline
+void xerr::owned::clear(void) noexcept
+{
+    m_pMessage = nullptr;
+    m_ChainPool.Free(m_iHead, m_iTail);
+}
+
+//------------------------------------------------------------------------------------
+// Hands the chain back to the calling thread (replacing whatever chain it had) so the regular
+// xerr API, including create<>(PrevError), keeps working with it. The owned error becomes empty
+inline
+xerr xerr::owned::Resume(void) noexcept
+{
+    m_ChainPool.Free(xerr_details::g_iCurChain, xerr_details::g_iCurTail);
+    xerr_details::g_iCurChain = std::exchange(m_iHead, index{ -1 });
+    xerr_details::g_iCurTail  = std::exchange(m_iTail, index{ -1 });
+    return { std::exchange(m_pMessage, nullptr) };
+}
+
+//------------------------------------------------------------------------------------
+
+template< typename T_CALLBACK> inline
+void xerr::owned::ForEachInChain(T_CALLBACK&& Callback) const noexcept requires std::invocable<T_CALLBACK, xerr>
+{
+    if (m_pMessage == nullptr) return;
+
+    if (m_iHead == -1)
+    {
+        Callback(xerr{ m_pMessage });
+    }
+    else
+    {
+        for (auto i = m_iTail; i != -1; i = m_ChainPool[i].m_iPrev)
+            Callback(xerr{ m_ChainPool.getError(i) });
+    }
+}
+
+//------------------------------------------------------------------------------------
+
+template< typename T_CALLBACK> inline
+void xerr::owned::ForEachInChainBackwards(T_CALLBACK&& Callback) const noexcept requires std::invocable<T_CALLBACK, xerr>
+{
+    if (m_pMessage == nullptr) return;
+
+    if (m_iHead == -1)
+    {
+        Callback(xerr{ m_pMessage });
+    }
+    else
+    {
+        for (auto i = m_iHead; i != -1; i = m_ChainPool[i].m_iNext)
+            Callback(xerr{ m_ChainPool.getError(i) });
+    }
+}
+
+//------------------------------------------------------------------------------------
+
+template< typename T_STATE_ENUM > constexpr
+T_STATE_ENUM xerr::getState(void) const noexcept requires (std::is_enum_v<T_STATE_ENUM>)
+{
+    assert(isState<T_STATE_ENUM>() || m_pMessage[-1] == static_cast<char>(T_STATE_ENUM::FAILURE) || xerr_details::isRemoteError(m_pMessage));
+    return m_pMessage ? static_cast<T_STATE_ENUM>(m_pMessage[-1]) : T_STATE_ENUM::OK;
+}
+
+//------------------------------------------------------------------------------------
+
+inline
+std::span<void* const> xerr::getStack(void) const noexcept
+{
+#if XERR_STACK_DEPTH
+    if (m_pMessage)
+    {
+        if (const auto* pSlot = xerr_details::g_StackPool.Find(m_pMessage); pSlot) return { pSlot->m_Frames.data(), pSlot->m_Depth };
+    }
+#endif
+    return {};
+}
+
+//------------------------------------------------------------------------------------
+// Only meant for printing, it may allocate (demangling) and it takes the loader lock
+inline
+std::string_view xerr::Symbolize(const void* pAddress, std::span<char> Buffer) noexcept
+{
+    if (Buffer.empty()) return {};
+
+    const auto Address = reinterpret_cast<std::uintptr_t>(pAddress);
+    int        Length  = -1;
+
+#if __has_include(<dlfcn.h>)
+    if (Dl_info Info; dladdr(pAddress, &Info) && Info.dli_fname)
+    {
+        const auto Offset = static_cast<unsigned long long>(Address - reinterpret_cast<std::uintptr_t>(Info.dli_fbase));
+        if (Info.dli_sname && Info.dli_saddr)
+        {
+            const char* pName     = Info.dli_sname;
+            char*       pDemangled = nullptr;
+    #if __has_include(<cxxabi.h>)
+            int Status = 0;
+            pDemangled = abi::__cxa_demangle(pName, nullptr, nullptr, &Status);
+            if (pDemangled && Status == 0) pName = pDemangled;
+    #endif
+            Length = std::snprintf(Buffer.data(), Buffer.size(), "%s+0x%llx (%s+0x%llx)", pName
+                                  , static_cast<unsigned long long>(Address - reinterpret_cast<std::uintptr_t>(Info.dli_saddr)), Info.dli_fname, Offset);
+            std::free(pDemangled);
+        }
+        else
+        {
+            Length = std::snprintf(Buffer.data(), Buffer.size(), "%s+0x%llx", Info.dli_fname, Offset);
+        }
+    }
+#endif
+
+    if (Length < 0) Length = std::snprintf(Buffer.data(), Buffer.size(), "0x%llx", static_cast<unsigned long long>(Address));
+    return { Buffer.data(), std::min(static_cast<std::size_t>(Length < 0 ? 0 : Length), Buffer.size() - 1) };
+}
+
+//------------------------------------------------------------------------------------
+
+template< typename T_OUT > inline
+T_OUT xerr::FormatTo(T_OUT Out, format_style Style, bool bSite) const noexcept
+{
+    return xerr_details::FormatChain(*this, std::move(Out), Style, bSite);
+}
 
-            std::size_t end = start;
-            while (sig[end] != '>' && sig[end] != '\0') ++end;
+//------------------------------------------------------------------------------------
+// Truncates to the buffer, the text is always null terminated
+inline
+std::string_view xerr::Format(std::span<char> Buffer, format_style Style, bool bSite) const noexcept
+{
+    if (Buffer.empty()) return {};
 
-            std::array<char, 128> result = {};
-            for (std::size_t i = start; i < end && i - start < result.size(); ++i)
-            {
-                result[i - start] = sig[i];
-            }
-            result[end - start] = '\0';
+    const auto Writer = FormatTo(xerr_details::buffer_writer{ Buffer.data(), Buffer.size() - 1, 0 }, Style, bSite);
+    const auto Length = std::min(Writer.m_Count, Buffer.size() - 1);
+    Buffer[Length] = 0;
+    return { Buffer.data(), Length };
+}
 
-            return result;
-        }
-    }
-#else
+//------------------------------------------------------------------------------------
 
-    //------------------------------------------------------------------------------------
+template< auto T_STATE_V, typename T_CALLBACK > constexpr
+xerr_details::match_case<decltype(T_STATE_V), static_cast<std::uint32_t>(T_STATE_V), std::decay_t<T_CALLBACK>> xerr::on(T_CALLBACK&& Callback) noexcept requires (std::is_enum_v<decltype(T_STATE_V)>)
+{
+    return { std::forward<T_CALLBACK>(Callback) };
+}
 
-    template<typename T_STATE_ENUM>
-    consteval static uint32_t create_uid(void) noexcept
-    {
-        const char*     s       = __PRETTY_FUNCTION__;
-        std::uint32_t   hash    = 5381;
-        for (int i = 0; (s[i]); ++i)  
-            hash = ((hash << 5) + hash) + s[i];
-        return hash;
-    }
+//------------------------------------------------------------------------------------
 
-    //------------------------------------------------------------------------------------
+template< typename T_STATE_ENUM, typename T_CALLBACK > constexpr
+xerr_details::match_case<T_STATE_ENUM, xerr_details::any_state_v, std::decay_t<T_CALLBACK>> xerr::on(T_CALLBACK&& Callback) noexcept requires (std::is_enum_v<T_STATE_ENUM>)
+{
+    return { std::forward<T_CALLBACK>(Callback) };
+}
 
-    namespace details
-    {
-        template<auto T>
-        consteval auto getValueTypeName() noexcept
-        {
-            constexpr const char* sig = __PRETTY_FUNCTION__;
-            constexpr std::size_t len = [] { std::size_t i = 0; while (sig[i] != '\0') ++i; return i; }();
-            constexpr const char* prefix = "T = ";
-            constexpr std::size_t prefix_len = [] { std::size_t i = 0; while (prefix[i] != '\0') ++i; return i; }();
+//------------------------------------------------------------------------------------
 
-            std::size_t start = 0;
-            for (std::size_t i = 0; i < len - prefix_len; ++i)
-            {
-                bool match = true;
-                for (std::size_t j = 0; j < prefix_len; ++j)
-                {
-                    if (sig[i + j] != prefix[j]) { match = false; break; }
-                }
-                if (match) { start = i + prefix_len; break; }
-            }
-            std::size_t end = start;
-            while (sig[end] != ']' && sig[end] != ';' && sig[end] != '\0') ++end;
-            std::array<char, 128> result = {};
+template< typename T_CALLBACK > constexpr
+xerr_details::match_otherwise<std::decay_t<T_CALLBACK>> xerr::otherwise(T_CALLBACK&& Callback) noexcept
+{
+    return { std::forward<T_CALLBACK>(Callback) };
+}
 
-            for (std::size_t i = start; i < end && i - start < result.size(); ++i)
-            {
-                result[i - start] = sig[i];
-            }
-            result[end - start] = '\0';
-            return result;
-        }
-    }
-#endif
+//------------------------------------------------------------------------------------
 
-    //------------------------------------------------------------------------------------
+template< typename... T_CASES > inline
+bool xerr::Match(T_CASES&&... Cases) const noexcept
+{
+    static_assert(sizeof...(T_CASES) > 0, "xerr::Match needs at least one handler");
+    using table = xerr_details::match_table<std::remove_reference_t<T_CASES>...>;
 
-    template<auto T>
-    inline static constexpr auto value_type_name_v = details::getValueTypeName<T>();
+    if (m_pMessage == nullptr) return false;
 
-    //------------------------------------------------------------------------------------
+    const auto Index = table::Find((std::uint64_t{ getStateUID() } << 16) | static_cast<std::uint8_t>(m_pMessage[-1]));
+    if (Index == table::count_v) return false;
 
-    // Template to get a unique 32 bit ID form a type
-    // Cross-compiler macro for type name
-    template<typename T_STATE_ENUM>
-    inline constexpr static uint32_t uid_v = create_uid<T_STATE_ENUM>();
+    const void* const pCases[] = { static_cast<const void*>(&Cases)... };
+    table::jump_v[Index](*this, pCases);
+    return true;
+}
 
-    //------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------
 
-    template< std::size_t T_SIZE_V >
-    struct info_construct
-    {
-        std::uint32_t m_TypeGUID;
-        char          m_State;
-        char          m_Message[T_SIZE_V];
-    };
+inline
+std::size_t xerr::getSerializedSize(void) const noexcept
+{
+    std::size_t nLinks = 0;
+    ForEachInChain([&](xerr) { ++nLinks; });
+    return serial_header_size_v + nLinks * serial_link_size_v;
+}
 
-    //------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------
+// Writes the chain into the caller's buffer. Returns the bytes written, 0 if it does not fit
+inline
+std::size_t xerr::Serialize(std::span<std::byte> Buffer) const noexcept
+{
+    const auto Size   = getSerializedSize();
+    const auto nLinks = (Size - serial_header_size_v) / serial_link_size_v;
+    if (Size > Buffer.size() || nLinks > 0xffff) return 0;
 
-    template <string_literal T_STR_V, auto T_STATE_V>
-    inline constexpr static auto data_v = []() consteval noexcept
+    auto Write = [p = Buffer.data()](std::uint64_t Value, int nBytes) mutable noexcept
     {
-        auto a = info_construct<T_STR_V.m_Value.size()>{};
-        a.m_TypeGUID = uid_v<decltype(T_STATE_V)>;
-        a.m_State = static_cast<char>(T_STATE_V);
-        for (std::size_t i = 0; (a.m_Message[i] = T_STR_V.m_Value[i]); ++i) {}
-        return a;
-    }();
+        for (int i = 0; i < nBytes; ++i) *p++ = static_cast<std::byte>(Value >> (8 * i));
+    };
 
-    //------------------------------------------------------------------------------------
+    Write(serial_magic_v,   4);
+    Write(serial_version_v, 1);
+    Write(0,                1);
+    Write(nLinks,           2);
 
-    inline chain_pool::chain_pool(void) noexcept
+    ForEachInChain([&](xerr Link)
     {
-        for (std::int16_t i = 0; i < m_Pool.size(); ++i) m_Pool[i].m_iNext = i + 1;
-        m_Pool[m_Pool.size() - 1].m_iNext = -1;
-        m_iEmpty.store(0, std::memory_order_relaxed);
-    }
+        Write(Link.getSiteID(),                                     8);
+        Write(static_cast<std::uint8_t>(Link.m_pMessage[-1]),       1);
+        Write(0,                                                    3);
+    });
 
-    //------------------------------------------------------------------------------------
-    // Lockless allocator
-    inline std::int16_t chain_pool::Alloc(void) noexcept
+    return Size;
+}
+
+//------------------------------------------------------------------------------------
+// Rebuilds the error and its chain (on the calling thread) from a Serialize buffer. The sites
+// are found in the catalog, the ones this binary does not know become an "Unknown remote error"
+// with the state the sender recorded. A known site recorded with another state means the buffer
+// is stale or corrupt, it is rejected as a whole.
+// Rehydrated errors are not reported to the callback, they were already reported by the sender
+inline
+xerr xerr::Deserialize(std::span<const std::byte> Buffer) noexcept
+{
+    auto Read = [&Buffer](std::size_t Offset, int nBytes) noexcept
     {
-        // Pop from free list
-        std::int16_t idx = m_iEmpty.load(std::memory_order_acquire);
-        while (idx != -1)
-        {
-            std::int16_t next = m_Pool[idx].m_iNext;
-            if (m_iEmpty.compare_exchange_weak(idx, next, std::memory_order_acq_rel))
-            {
-                return idx;
-            }
-        }
+        std::uint64_t Value = 0;
+        for (int i = 0; i < nBytes; ++i) Value |= static_cast<std::uint64_t>(Buffer[Offset + i]) << (8 * i);
+        return Value;
+    };
 
-        // Fallback: use index 0 if pool exhausted
-        assert(false);
-        return 0;
-    }
+    if (Buffer.size() < serial_header_size_v || Read(0, 4) != serial_magic_v || Read(4, 1) != serial_version_v)
+        return create_f<default_states, "Invalid serialized error|The buffer is not an xerr chain or its version is unknown">();
 
-    //------------------------------------------------------------------------------------
+    const auto nLinks = static_cast<std::size_t>(Read(6, 2));
+    if (nLinks == 0) return {};
+    if (Buffer.size() < serial_header_size_v + nLinks * serial_link_size_v)
+        return create_f<default_states, "Invalid serialized error|The buffer is truncated">();
 
-    inline void chain_pool::Free(std::int16_t& iHead, std::int16_t& iTail) noexcept
+    auto getLink = [&](std::size_t i) noexcept -> const char*
     {
-        if (iHead == -1)
-        {
-            assert(iTail == -1);
-            return;
-        }
+        const auto  Offset  = serial_header_size_v + i * serial_link_size_v;
+        const auto  State   = static_cast<std::uint8_t>(Read(Offset + 8, 1));
+        const auto* pEntry  = m_Catalog.Find(Read(Offset, 8));
 
-        // Atomically push chain to free list
-        std::int16_t old_head = m_iEmpty.load(std::memory_order_relaxed);
-        do
-        {
-            m_Pool[iTail].m_iNext = old_head;
+        if (pEntry == nullptr)                                                      return xerr_details::getRemoteErrors()[State].m_Message;
+        if (static_cast<std::uint8_t>(pEntry->m_pMessage[-1]) != State)             return nullptr;
+        return pEntry->m_pMessage;
+    };
 
-        } while (!m_iEmpty.compare_exchange_weak(old_head, iHead, std::memory_order_acq_rel));
+    for (std::size_t i = 0; i < nLinks; ++i)
+        if (getLink(i) == nullptr) return create_f<default_states, "Invalid serialized error|A link does not have the state of its site, the buffer is stale or corrupt">();
 
+    if (xerr_details::g_iCurChain != -1) m_ChainPool.Free(xerr_details::g_iCurChain, xerr_details::g_iCurTail);
 
-        iHead = iTail = -1;
+    xerr Err;
+    for (std::size_t i = 0; i < nLinks; ++i)
+    {
+        Err.m_pMessage = getLink(i);
+        if (nLinks > 1) xerr_details::CreateEntry(Err.m_pMessage);
     }
 
-    //------------------------------------------------------------------------------------
+    return Err;
+}
 
-    thread_local inline static std::int16_t g_iCurChain = -1; // -1 means no chain
-    thread_local inline static std::int16_t g_iCurTail  = -1; // -1 means no chain
+//------------------------------------------------------------------------------------
 
-    //------------------------------------------------------------------------------------
+template <auto T_STATE_V, xerr_details::string_literal T_STR_V>  constexpr
+ xerr xerr::create(const location<T_STATE_V> loc) noexcept requires (std::is_enum_v<decltype(T_STATE_V)>)
+{
+    static_assert(sizeof(T_STATE_V) == 1);
+    if (xerr_details::g_iCurChain != -1) m_ChainPool.Free(xerr_details::g_iCurChain, xerr_details::g_iCurTail);
+    xerr_details::ReportError<T_STATE_V, T_STR_V>(loc);
+    return { xerr_details::data_v<T_STR_V, T_STATE_V>.m_Message };
+}
 
-    inline auto& CreateEntry(void) noexcept
-    {
-        auto  iNewIndex = xerr::m_ChainPool.Alloc();
-        auto& Entry     = xerr::m_ChainPool.m_Pool[iNewIndex];
-        Entry.m_iNext   = xerr_details::g_iCurChain;
-        Entry.m_iPrev   = -1;
+//------------------------------------------------------------------------------------
 
-        if (xerr_details::g_iCurChain != -1) xerr::m_ChainPool.m_Pool[xerr_details::g_iCurChain].m_iPrev = iNewIndex;
-        xerr_details::g_iCurChain = iNewIndex;
-        return Entry;
-    };
+template <auto T_STATE_V, xerr_details::string_literal T_STR_V> constexpr
+ xerr xerr::create(const xerr PrevError, const location<T_STATE_V> loc) noexcept requires (std::is_enum_v<decltype(T_STATE_V)>)
+{
+    static_assert(sizeof(T_STATE_V) == 1);
+
+    // If there is nothing to chain with then just do the regular thing...
+    if (PrevError.m_pMessage == nullptr ) 
+        return xerr::create<T_STATE_V, T_STR_V>(loc);
+
+    if (xerr_details::g_iCurChain == -1) xerr_details::CreateEntry(PrevError.m_pMessage);
+
+    // Note that we must not call the unchained create here since it releases the current chain
+    const xerr Err{ xerr_details::data_v<T_STR_V, T_STATE_V>.m_Message };
+    xerr_details::CreateEntry(Err.m_pMessage);
+    xerr_details::ReportError<T_STATE_V, T_STR_V>(loc);
+    return Err;
 }
 
 //------------------------------------------------------------------------------------
 
-constexpr
-xerr::operator bool(void) const noexcept
+template< typename... T_ARGS > constexpr
+xerr_details::context_args<sizeof...(T_ARGS)> xerr::args(const T_ARGS&... Args) noexcept
 {
-    return !!m_pMessage;
+    return { { xerr_details::MakeContextArg(Args)... } };
 }
 
 //------------------------------------------------------------------------------------
-
-inline
-void xerr::clear(void) noexcept
+// Same as the regular create but the {} of the message get the arguments. They are copied
+// into the thread's context arena and only formatted when the message is read
+template <auto T_STATE_V, xerr_details::string_literal T_STR_V, std::size_t T_COUNT_V> inline
+xerr xerr::create(const xerr_details::context_args<T_COUNT_V>& Args, const location<T_STATE_V> loc) noexcept requires (std::is_enum_v<decltype(T_STATE_V)>)
 {
-    m_pMessage = nullptr;
-    xerr_details::g_iCurChain = -1;
+    static_assert(sizeof(T_STATE_V) == 1);
+    constexpr auto& Data = xerr_details::data_v<T_STR_V, T_STATE_V>;
+    static_assert(Data.m_nArgs == T_COUNT_V, "xerr::args must have one argument per {} in the message");
+
+    if (xerr_details::g_iCurChain != -1) m_ChainPool.Free(xerr_details::g_iCurChain, xerr_details::g_iCurTail);
+    xerr_details::ReportError<T_STATE_V, T_STR_V>(loc, xerr_details::g_ContextArena.Capture(Data.m_Message, Args.m_Args));
+    return { Data.m_Message };
 }
 
 //------------------------------------------------------------------------------------
 
-constexpr
-std::uint32_t xerr::getStateUID(void) const noexcept
+template <auto T_STATE_V, xerr_details::string_literal T_STR_V, std::size_t T_COUNT_V> inline
+xerr xerr::create(const xerr PrevError, const xerr_details::context_args<T_COUNT_V>& Args, const location<T_STATE_V> loc) noexcept requires (std::is_enum_v<decltype(T_STATE_V)>)
 {
-    return m_pMessage ? reinterpret_cast<const std::uint32_t&>(m_pMessage[-5]) : 0;
+    static_assert(sizeof(T_STATE_V) == 1);
+    constexpr auto& Data = xerr_details::data_v<T_STR_V, T_STATE_V>;
+    static_assert(Data.m_nArgs == T_COUNT_V, "xerr::args must have one argument per {} in the message");
+
+    if (PrevError.m_pMessage == nullptr)
+        return xerr::create<T_STATE_V, T_STR_V>(Args, loc);
+
+    if (xerr_details::g_iCurChain == -1) xerr_details::CreateEntry(PrevError.m_pMessage);
+
+    xerr_details::CreateEntry(Data.m_Message);
+    xerr_details::ReportError<T_STATE_V, T_STR_V>(loc, xerr_details::g_ContextArena.Capture(Data.m_Message, Args.m_Args));
+    return { Data.m_Message };
 }
 
 //------------------------------------------------------------------------------------
 
-template< typename T_STATE_ENUM > consteval
-std::uint32_t xerr::fromStateUID(void) noexcept requires (std::is_enum_v<T_STATE_ENUM>)
+template <typename T_STATE_ENUM, xerr_details::string_literal T_STR_V> constexpr
+xerr xerr::create_f(const location<T_STATE_ENUM::FAILURE> loc) noexcept requires (std::is_enum_v<T_STATE_ENUM>)
 {
-    return xerr_details::uid_v<T_STATE_ENUM>;
+    return create<T_STATE_ENUM::FAILURE, T_STR_V>(loc);
 }
 
 //------------------------------------------------------------------------------------
 
-template< typename T_STATE_ENUM > constexpr
-bool xerr::isState(void) const noexcept requires (std::is_enum_v<T_STATE_ENUM>)
+template <typename T_STATE_ENUM, xerr_details::string_literal T_STR_V> constexpr
+xerr xerr::create_f(const xerr PrevError, const location<T_STATE_ENUM::FAILURE> loc) noexcept requires (std::is_enum_v<T_STATE_ENUM>)
 {
-    return m_pMessage == nullptr || xerr_details::uid_v<T_STATE_ENUM> == getStateUID();
+    return create<T_STATE_ENUM::FAILURE, T_STR_V>(PrevError, loc);
 }
 
 //------------------------------------------------------------------------------------
 
-constexpr
-bool xerr::hasChain(void) const noexcept
+template <typename T_STATE_ENUM, xerr_details::string_literal T_STR_V, std::size_t T_COUNT_V> inline
+xerr xerr::create_f(const xerr_details::context_args<T_COUNT_V>& Args, const location<T_STATE_ENUM::FAILURE> loc) noexcept requires (std::is_enum_v<T_STATE_ENUM>)
 {
-    return m_pMessage != nullptr && xerr_details::g_iCurChain != -1;
+    return create<T_STATE_ENUM::FAILURE, T_STR_V>(Args, loc);
 }
 
 //------------------------------------------------------------------------------------
 
-inline
-std::string_view xerr::getMessageFromString(const char* pMessage) noexcept
+template <typename T_STATE_ENUM, xerr_details::string_literal T_STR_V, std::size_t T_COUNT_V> inline
+xerr xerr::create_f(const xerr PrevError, const xerr_details::context_args<T_COUNT_V>& Args, const location<T_STATE_ENUM::FAILURE> loc) noexcept requires (std::is_enum_v<T_STATE_ENUM>)
 {
-    if (pMessage == nullptr) return {};
+    return create<T_STATE_ENUM::FAILURE, T_STR_V>(PrevError, Args, loc);
+}
 
-    int i = 0;
-    while (pMessage[i] && pMessage[i] != '|') ++i;
+//------------------------------------------------------------------------------------
 
-    return { pMessage, pMessage + i };
+template <auto T_STATE_V> constexpr
+void xerr::LogMessage(std::string_view Message, const location<T_STATE_V> loc ) noexcept requires (std::is_enum_v<decltype(T_STATE_V)>)
+{
+    xerr_details::Report<T_STATE_V>(nullptr, Message, loc);
 }
 
 //------------------------------------------------------------------------------------
 
-inline
-std::string_view xerr::getMessage(void) const noexcept
+template <auto T_STATE_V> constexpr
+void xerr::LogMessage(std::string&& Message, const location<T_STATE_V> loc ) noexcept requires (std::is_enum_v<decltype(T_STATE_V)>)
 {
-    return getMessageFromString(m_pMessage);
+    xerr_details::Report<T_STATE_V>(nullptr, Message, loc);
 }
 
 //------------------------------------------------------------------------------------
-inline
-std::string_view xerr::getMessageFromMsg(std::string_view msg) noexcept
+// RESULT
+//------------------------------------------------------------------------------------
+
+template< typename T > inline
+std::uintptr_t xerr::result<T>::Pack(T Value) noexcept requires (packed_v)
 {
-    if (msg.empty()) return {};
+    if constexpr (std::is_pointer_v<T>)
+    {
+        return reinterpret_cast<std::uintptr_t>(Value);
+    }
+    else
+    {
+        using int_t = typename std::conditional_t< std::is_enum_v<T>, std::underlying_type<T>, std::type_identity<T> >::type;
+        if constexpr (std::is_same_v<std::remove_cv_t<int_t>, bool>) return static_cast<std::uintptr_t>(static_cast<int_t>(Value)) << 1;
+        else                                                         return static_cast<std::uintptr_t>(static_cast<std::make_unsigned_t<int_t>>(static_cast<int_t>(Value))) << 1;
+    }
+}
 
-    std::size_t i   = 0;
-    const auto  end = msg.length();
-    while ( i < end && msg[i] != '|') ++i;
+//------------------------------------------------------------------------------------
 
-    return { msg.begin(), msg.begin() + i};
+template< typename T > inline
+T xerr::result<T>::Unpack(std::uintptr_t Bits) noexcept requires (packed_v)
+{
+    if constexpr (std::is_pointer_v<T>)
+    {
+        return reinterpret_cast<T>(Bits);
+    }
+    else
+    {
+        using int_t = typename std::conditional_t< std::is_enum_v<T>, std::underlying_type<T>, std::type_identity<T> >::type;
+        if constexpr (std::is_same_v<std::remove_cv_t<int_t>, bool>) return static_cast<T>((Bits >> 1) != 0);
+        else                                                         return static_cast<T>(static_cast<int_t>(static_cast<std::make_unsigned_t<int_t>>(Bits >> 1)));
+    }
 }
 
 //------------------------------------------------------------------------------------
-inline
-std::string_view xerr::getHintFromMsg(std::string_view msg) noexcept
+// An empty xerr has no error to hold, it becomes a FAILURE so the result is never left without a value
+template< typename T > inline
+xerr::result<T>::result(xerr Error) noexcept
 {
-    if (msg.empty()) return {};
+    assert(Error && "xerr::result needs a value or an error");
+    const char* pMessage = Error ? Error.m_pMessage : xerr_details::data_v<"Empty error|An xerr::result was built from an xerr without an error", default_states::FAILURE>.m_Message;
 
-    std::size_t iStart  = 0;
-    const auto  end     = msg.length();
-    while (iStart < end && msg[iStart] != '|') ++iStart;
+    if constexpr (packed_v) m_Data          = reinterpret_cast<std::uintptr_t>(pMessage);
+    else                    m_Data.m_pMessage = pMessage;
+}
 
-    if (msg[iStart] != '|') return {};
+//------------------------------------------------------------------------------------
 
-    return { msg.begin() + iStart, msg.end()};
+template< typename T > inline
+xerr::result<T>::result(const T& Value) noexcept requires (std::is_nothrow_copy_constructible_v<T>)
+{
+    if constexpr (packed_v) m_Data = Pack(Value);
+    else                    ::new(&m_Data.m_Value) T(Value);
 }
 
 //------------------------------------------------------------------------------------
 
-inline
-std::string_view xerr::getHintFromString(const char* pMessage) noexcept
+template< typename T > inline
+xerr::result<T>::result(T&& Value) noexcept requires (std::is_nothrow_move_constructible_v<T> && !packed_v)
 {
-    if (pMessage == nullptr) return {};
-    int iStart = 0;
-    while (pMessage[iStart] && pMessage[iStart] != '|') iStart++;
-    if (pMessage[iStart] != '|') return {};
-    ++iStart;
-    int iEnd = iStart + 1;
-    while (pMessage[iEnd]) iEnd++;
-    return { pMessage + iStart, pMessage + iEnd };
+    ::new(&m_Data.m_Value) T(std::move(Value));
 }
 
 //------------------------------------------------------------------------------------
 
-inline
-std::string_view xerr::getHint(void) const noexcept
+template< typename T > inline
+xerr::result<T>::result(const result& Other) noexcept requires (!packed_v && !std::is_trivially_copy_constructible_v<T>)
 {
-    return getHintFromString(m_pMessage);
+    m_Data.m_pMessage = Other.m_Data.m_pMessage;
+    if (m_Data.m_pMessage == nullptr) ::new(&m_Data.m_Value) T(Other.m_Data.m_Value);
 }
 
 //------------------------------------------------------------------------------------
 
-template< typename T_CALLBACK> inline
-void xerr::ForEachInChain(T_CALLBACK&& Callback) const noexcept requires std::invocable<T_CALLBACK, xerr>
+template< typename T > inline
+xerr::result<T>::result(result&& Other) noexcept requires (!packed_v && !std::is_trivially_move_constructible_v<T>)
 {
-    if( m_pMessage == nullptr ) return;
+    m_Data.m_pMessage = Other.m_Data.m_pMessage;
+    if (m_Data.m_pMessage == nullptr) ::new(&m_Data.m_Value) T(std::move(Other.m_Data.m_Value));
+}
 
-    if(xerr_details::g_iCurChain == -1)
-    {
-        Callback(*this);
-    }
-    else
+//------------------------------------------------------------------------------------
+
+template< typename T > inline
+xerr::result<T>& xerr::result<T>::operator = (const result& Other) noexcept requires (!trivial_copy_v)
+{
+    if (this != &Other)
     {
-        for (auto i = xerr_details::g_iCurTail; i != -1; i = m_ChainPool.m_Pool[i].m_iPrev)
-            Callback(xerr{ m_ChainPool.m_Pool[i].m_pError });
+        this->~result();
+        ::new(this) result(Other);
     }
+    return *this;
 }
 
 //------------------------------------------------------------------------------------
 
-template< typename T_CALLBACK> inline
-void xerr::ForEachInChainBackwards(T_CALLBACK&& Callback) const noexcept requires std::invocable<T_CALLBACK, xerr>
+template< typename T > inline
+xerr::result<T>& xerr::result<T>::operator = (result&& Other) noexcept requires (!trivial_move_v)
 {
-    if (m_pMessage == nullptr) return;
-
-    if (xerr_details::g_iCurChain == -1)
-    {
-        Callback(*this);
-    }
-    else
+    if (this != &Other)
     {
-        for (auto i = xerr_details::g_iCurChain; i != -1; i = m_ChainPool.m_Pool[i].m_iNext)
-            Callback(xerr{ m_ChainPool.m_Pool[i].m_pError });
+        this->~result();
+        ::new(this) result(std::move(Other));
     }
+    return *this;
 }
 
 //------------------------------------------------------------------------------------
 
-template< typename T_STATE_ENUM > constexpr
-T_STATE_ENUM xerr::getState(void) const noexcept requires (std::is_enum_v<T_STATE_ENUM>)
+template< typename T > inline
+xerr::result<T>::~result(void) noexcept requires (!packed_v && !std::is_trivially_destructible_v<T>)
 {
-    assert(isState<T_STATE_ENUM>() || m_pMessage[-1] == static_cast<char>(T_STATE_ENUM::FAILURE));
-    return m_pMessage ? static_cast<T_STATE_ENUM>(m_pMessage[-1]) : T_STATE_ENUM::OK;
+    if (m_Data.m_pMessage == nullptr) m_Data.m_Value.~T();
 }
 
 //------------------------------------------------------------------------------------
 
-template <auto T_STATE_V, xerr_details::string_literal T_STR_V>  constexpr
- xerr xerr::create(const std::source_location loc) noexcept requires (std::is_enum_v<decltype(T_STATE_V)>)
+template< typename T > inline
+bool xerr::result<T>::hasValue(void) const noexcept
 {
-    static_assert(sizeof(T_STATE_V) == 1);
-    if (xerr_details::g_iCurChain != -1) m_ChainPool.Free(xerr_details::g_iCurChain, xerr_details::g_iCurTail);
-    if (m_pCallback) m_pCallback(xerr_details::value_type_name_v<T_STATE_V>.data(), static_cast<std::uint8_t>(T_STATE_V), T_STR_V.m_Value.data(), loc.line(), loc.file_name());
-    return { xerr_details::data_v<T_STR_V, T_STATE_V>.m_Message };
+    if constexpr (packed_v) return (m_Data & 1) == 0;
+    else                    return m_Data.m_pMessage == nullptr;
 }
 
 //------------------------------------------------------------------------------------
 
-template <auto T_STATE_V, xerr_details::string_literal T_STR_V> constexpr
- xerr xerr::create(const xerr PrevError, const std::source_location loc) noexcept requires (std::is_enum_v<decltype(T_STATE_V)>)
+template< typename T > inline
+xerr xerr::result<T>::getError(void) const noexcept
 {
-    static_assert(sizeof(T_STATE_V) == 1);
-
-    // If there is nothing to chain with then just do the regular thing...
-    if (PrevError.m_pMessage == nullptr ) 
-        return xerr::create<T_STATE_V, T_STR_V>();
+    if constexpr (packed_v) return { hasValue() ? nullptr : reinterpret_cast<const char*>(m_Data) };
+    else                    return { m_Data.m_pMessage };
+}
 
-    if (xerr_details::g_iCurChain == -1)
-    {
-        xerr_details::CreateEntry().m_pError = PrevError.m_pMessage;
-        xerr_details::g_iCurTail = xerr_details::g_iCurChain;
-    }
+//------------------------------------------------------------------------------------
 
-    auto Err = create<T_STATE_V, T_STR_V>();
-    xerr_details::CreateEntry().m_pError = Err.m_pMessage;
-    if (m_pCallback) m_pCallback(xerr_details::value_type_name_v<T_STATE_V>.data(), static_cast<std::uint8_t>(T_STATE_V), T_STR_V.m_Value.data(), loc.line(), loc.file_name());
-    return Err;
+template< typename T > inline
+T xerr::result<T>::getValue(void) const noexcept requires (packed_v)
+{
+    assert(hasValue());
+    return Unpack(m_Data);
 }
 
 //------------------------------------------------------------------------------------
 
-template <typename T_STATE_ENUM, xerr_details::string_literal T_STR_V> constexpr
-xerr xerr::create_f(const std::source_location loc) noexcept requires (std::is_enum_v<T_STATE_ENUM>)
+template< typename T > inline
+T& xerr::result<T>::getValue(void) & noexcept requires (!packed_v)
 {
-    return create<T_STATE_ENUM::FAILURE, T_STR_V>(loc);
+    assert(hasValue());
+    return m_Data.m_Value;
 }
 
 //------------------------------------------------------------------------------------
 
-template <typename T_STATE_ENUM, xerr_details::string_literal T_STR_V> constexpr
-xerr xerr::create_f(const xerr PrevError, const std::source_location loc) noexcept requires (std::is_enum_v<T_STATE_ENUM>)
+template< typename T > inline
+const T& xerr::result<T>::getValue(void) const& noexcept requires (!packed_v)
 {
-    return create<T_STATE_ENUM::FAILURE, T_STR_V>(PrevError, loc);
+    assert(hasValue());
+    return m_Data.m_Value;
 }
 
 //------------------------------------------------------------------------------------
 
-template <auto T_STATE_V> constexpr
-void xerr::LogMessage(std::string_view Message, const std::source_location loc ) noexcept requires (std::is_enum_v<decltype(T_STATE_V)>)
+template< typename T > inline
+T&& xerr::result<T>::getValue(void) && noexcept requires (!packed_v)
 {
-    if (m_pCallback) m_pCallback(xerr_details::value_type_name_v<T_STATE_V>.data(), static_cast<std::uint8_t>(T_STATE_V), Message, loc.line(), loc.file_name());
+    assert(hasValue());
+    return std::move(m_Data.m_Value);
 }
 
 //------------------------------------------------------------------------------------
 
-template <auto T_STATE_V> constexpr
-void xerr::LogMessage(std::string&& Message, const std::source_location loc ) noexcept requires (std::is_enum_v<decltype(T_STATE_V)>)
+template< typename T > inline
+T xerr::result<T>::getValueOr(T Default) const noexcept requires (std::is_nothrow_copy_constructible_v<T>)
 {
-    if (m_pCallback) m_pCallback(xerr_details::value_type_name_v<T_STATE_V>.data(), static_cast<std::uint8_t>(T_STATE_V), Message, loc.line(), loc.file_name() );
+    return hasValue() ? getValue() : Default;
 }
-
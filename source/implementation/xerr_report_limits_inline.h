@@ -0,0 +1,104 @@
+#include "xerr_clock_inline.h"
+
+#include <algorithm>
+#include <charconv>
+
+namespace xerr_details
+{
+    //------------------------------------------------------------------------------------
+    // REPORT LIMITS
+    //------------------------------------------------------------------------------------
+
+    inline bool site_limiter::Allow(void) noexcept
+    {
+        if (m_bRegistered.load(std::memory_order_relaxed) == false && m_bRegistered.exchange(true, std::memory_order_acq_rel) == false)
+            g_ReportLimits.Register(*this);
+
+        const auto Now      = SteadyNow();
+        auto       FullTime = m_FullTime.load(std::memory_order_relaxed);
+        do
+        {
+            // Taking a token pushes the full time one interval further, a bucket that would
+            // need more than burst_v intervals to refill has no token left
+            const auto Next = std::max(FullTime, Now) + interval_v;
+            if (Next - Now > burst_v * interval_v)
+            {
+                m_Suppressed.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+
+            if (m_FullTime.compare_exchange_weak(FullTime, Next, std::memory_order_relaxed)) break;
+        } while (true);
+
+        // We are allowed again, tell how many went missing before this one
+        if (m_Suppressed.load(std::memory_order_relaxed))
+        {
+            if (const auto Count = m_Suppressed.exchange(0, std::memory_order_relaxed); Count) limiter_registry::Summarize(*this, Count);
+        }
+        return true;
+    }
+
+    //------------------------------------------------------------------------------------
+
+    inline void limiter_registry::Register(site_limiter& Site) noexcept
+    {
+        Site.m_pNext = m_pHead.load(std::memory_order_relaxed);
+        while (!m_pHead.compare_exchange_weak(Site.m_pNext, &Site, std::memory_order_release, std::memory_order_relaxed)) {}
+    }
+
+    //------------------------------------------------------------------------------------
+    // Returns the number of sites that had something to report
+    inline std::size_t limiter_registry::Flush(void) noexcept
+    {
+        std::size_t nSites = 0;
+        for (auto* pSite = m_pHead.load(std::memory_order_acquire); pSite; pSite = pSite->m_pNext)
+        {
+            if (pSite->m_Suppressed.load(std::memory_order_relaxed) == 0) continue;
+            if (const auto Count = pSite->m_Suppressed.exchange(0, std::memory_order_relaxed); Count)
+            {
+                Summarize(*pSite, Count);
+                ++nSites;
+            }
+        }
+        return nSites;
+    }
+
+    //------------------------------------------------------------------------------------
+    // Sent like a LogMessage of the site state: "message (N suppressed)" without a location
+    inline void limiter_registry::Summarize(const site_limiter& Site, std::uint64_t Count) noexcept
+    {
+        const auto Message = xerr::getMessageFromString(Site.m_pMessage);
+        char       Text[sink_text_size_v];
+        char       Suffix[40] = " (";
+        auto       pEnd       = std::to_chars(&Suffix[2], &Suffix[sizeof(Suffix) - 12], Count).ptr;
+        pEnd = std::copy_n(" suppressed)", 12, pEnd);
+
+        // The count must survive the truncation of a long message
+        const auto SuffixLength  = static_cast<std::size_t>(pEnd - Suffix);
+        const auto MessageLength = std::min(Message.size(), sizeof(Text) - SuffixLength);
+        std::copy_n(Message.data(), MessageLength, Text);
+        std::copy_n(Suffix, SuffixLength, &Text[MessageLength]);
+        const std::string_view Summary{ Text, MessageLength + SuffixLength };
+
+        if (auto* pSinkPush = xerr::m_pSinkPush.load(std::memory_order_relaxed); pSinkPush) pSinkPush(Site.m_pStateName, Site.m_State, nullptr, Summary, "", 0);
+        else if (auto* pCallback = xerr::m_pCallback; pCallback)                             pCallback(Site.m_pStateName, Site.m_State, Summary, 0, "");
+    }
+
+    //------------------------------------------------------------------------------------
+
+    template <string_literal T_STR_V, auto T_STATE_V>
+    inline site_limiter site_limiter_v{ data_v<T_STR_V, T_STATE_V>.m_Message, getStateName<T_STATE_V>(), static_cast<std::uint8_t>(T_STATE_V) };
+
+    //------------------------------------------------------------------------------------
+    // Hooks called by Report and ReportError (declared in xerr_inline.h)
+    template< string_literal T_STR_V, auto T_STATE_V >
+    inline site_limiter& getSiteLimiter(void) noexcept
+    {
+        return site_limiter_v<T_STR_V, T_STATE_V>;
+    }
+
+    inline bool AllowReport(site_limiter& Limiter) noexcept
+    {
+        return Limiter.Allow();
+    }
+}
@@ -0,0 +1,258 @@
+#include "xerr_clock_inline.h"
+
+#include <cassert>
+#include <new>
+
+namespace xerr_details
+{
+    //------------------------------------------------------------------------------------
+    // ASYNC SINK
+    //------------------------------------------------------------------------------------
+
+    inline std::string_view record::getMessage(void) const noexcept
+    {
+        if (m_pMessage == nullptr) return { m_Text, m_TextLength };
+        const auto& Info = GetInfo(m_pMessage);
+        return { m_pMessage, static_cast<std::size_t>(Info.m_HintOffset + Info.m_HintLength) };
+    }
+
+    //------------------------------------------------------------------------------------
+    // Full text of the record, with the arguments of the error (if any) formatted into Buffer
+    inline std::string_view record::Format(std::span<char> Buffer) const noexcept
+    {
+        if (m_pMessage == nullptr || m_TextLength == 0) return getMessage();
+
+        std::size_t MessageLength;
+        const auto  Length = FormatContext(m_pMessage, { reinterpret_cast<const std::byte*>(m_Text), m_TextLength }, Buffer, MessageLength);
+        return { Buffer.data(), Length };
+    }
+
+    //------------------------------------------------------------------------------------
+    // Marks the ring of the thread as dead when the thread goes away, the drain releases it
+    struct sink_ring_owner
+    {
+        inline ~sink_ring_owner(void) noexcept { if (m_pRing) m_pRing->m_bDead.store(true, std::memory_order_release); }
+        sink_ring* m_pRing = nullptr;
+    };
+
+    thread_local inline sink_ring_owner g_SinkRing = {};
+
+    //------------------------------------------------------------------------------------
+    // What xerr::m_pSinkPush points to while g_AsyncSink runs. A producer can load the pointer
+    // just before Stop clears it: Stop waits for the pushes in flight before its last drain, and
+    // a producer that gets here after Stop delivers its record itself
+    inline void SinkPush(const char* pStateName, std::uint8_t State, const char* pMessage, std::string_view Text, const char* pFile, std::uint32_t Line) noexcept
+    {
+        g_AsyncSink.m_nPushing.fetch_add(1, std::memory_order_seq_cst);
+        const bool bRunning = g_AsyncSink.m_bRunning.load(std::memory_order_seq_cst);
+        if (bRunning) g_AsyncSink.Push(pStateName, State, pMessage, Text, pFile, Line);
+        g_AsyncSink.m_nPushing.fetch_sub(1, std::memory_order_release);
+        if (bRunning) return;
+
+        record Record;
+        async_sink::Fill(Record, pStateName, State, pMessage, Text, pFile, Line);
+        g_AsyncSink.Deliver(Record);
+    }
+
+    //------------------------------------------------------------------------------------
+
+    inline async_sink::~async_sink(void) noexcept
+    {
+        Stop();
+    }
+
+    //------------------------------------------------------------------------------------
+    // Period == 0 does not start a thread, the user is expected to call Drain
+    inline void async_sink::Start(fn_record_callback* pCallback, std::chrono::milliseconds Period) noexcept
+    {
+        Stop();
+
+        m_pRecordCallback = pCallback;
+        m_bExit.store(false, std::memory_order_relaxed);
+        m_bRunning.store(true, std::memory_order_release);
+        if (this == &g_AsyncSink) xerr::m_pSinkPush.store(&SinkPush, std::memory_order_release);
+
+        if (Period.count()) m_Thread = std::thread([this, Period]
+        {
+            auto LastFlush = SteadyNow();
+            while (m_bExit.load(std::memory_order_acquire) == false)
+            {
+                if (DrainRings() == 0) std::this_thread::sleep_for(Period);
+
+                // Sites that went quiet while suppressed still get their summary
+#if XERR_REPORT_RATE
+                if (const auto Now = SteadyNow(); Now - LastFlush >= 1'000'000'000)
+                {
+                    g_ReportLimits.Flush();
+                    LastFlush = Now;
+                }
+#else
+                (void)LastFlush;
+#endif
+            }
+        });
+    }
+
+    //------------------------------------------------------------------------------------
+
+    inline void async_sink::Stop(void) noexcept
+    {
+        // Pending summaries go out with the rest of the records
+#if XERR_REPORT_RATE
+        if (isRunning()) g_ReportLimits.Flush();
+#endif
+
+        xerr::m_pSinkPush.store(nullptr, std::memory_order_release);
+        m_bRunning.store(false, std::memory_order_seq_cst);
+
+        // Producers that loaded m_pSinkPush before it was cleared may still be writing their record
+        while (m_nPushing.load(std::memory_order_seq_cst)) std::this_thread::yield();
+
+        m_bExit.store(true, std::memory_order_release);
+        if (m_Thread.joinable()) m_Thread.join();
+        DrainRings();
+    }
+
+    //------------------------------------------------------------------------------------
+
+    inline bool async_sink::isRunning(void) const noexcept
+    {
+        return m_bRunning.load(std::memory_order_relaxed);
+    }
+
+    //------------------------------------------------------------------------------------
+
+    inline sink_ring* async_sink::getRing(void) noexcept
+    {
+        auto& Owner = g_SinkRing;
+        if (Owner.m_pRing) return Owner.m_pRing;
+
+        // First record of this thread, register a ring (this is the only allocation of the sink)
+        auto* pRing = new (std::nothrow) sink_ring;
+        if (pRing == nullptr) return nullptr;
+
+        pRing->m_pNext = m_pRings.load(std::memory_order_relaxed);
+        while (!m_pRings.compare_exchange_weak(pRing->m_pNext, pRing, std::memory_order_release, std::memory_order_relaxed)) {}
+        return Owner.m_pRing = pRing;
+    }
+
+    //------------------------------------------------------------------------------------
+
+    inline void async_sink::Push(const char* pStateName, std::uint8_t State, const char* pMessage, std::string_view Text, const char* pFile, std::uint32_t Line) noexcept
+    {
+        auto* pRing = getRing();
+        if (pRing == nullptr)
+        {
+            m_DropCount.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        const auto Head = pRing->m_Head.load(std::memory_order_relaxed);
+        if (Head - pRing->m_Tail.load(std::memory_order_acquire) == sink_ring::size_v)
+        {
+            m_DropCount.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        Fill(pRing->m_Records[Head & (sink_ring::size_v - 1)], pStateName, State, pMessage, Text, pFile, Line);
+        pRing->m_Head.store(Head + 1, std::memory_order_release);
+    }
+
+    //------------------------------------------------------------------------------------
+
+    inline void async_sink::Fill(record& Record, const char* pStateName, std::uint8_t State, const char* pMessage, std::string_view Text, const char* pFile, std::uint32_t Line) noexcept
+    {
+        Record.m_pMessage   = pMessage;
+        Record.m_pStateName = pStateName;
+        Record.m_pFile      = pFile;
+        Record.m_Timestamp  = SystemNow();
+        Record.m_Line       = Line;
+        Record.m_State      = State;
+        Record.m_TextLength = static_cast<std::uint8_t>(Text.size() < sizeof(Record.m_Text) ? Text.size() : sizeof(Record.m_Text));
+        for (std::size_t i = 0; i < Record.m_TextLength; ++i) Record.m_Text[i] = Text[i];
+    }
+
+    //------------------------------------------------------------------------------------
+
+    inline void async_sink::Deliver(const record& Record) const noexcept
+    {
+        if (m_pRecordCallback)
+        {
+            m_pRecordCallback(Record);
+        }
+        else if (auto* pCallback = xerr::m_pCallback; pCallback)
+        {
+            std::string_view Message = Record.getMessage();
+
+            // Arguments are formatted here, on the drain side
+            alignas(8) char Buffer[512];
+            if (Record.m_pMessage && Record.m_TextLength)
+            {
+                const auto* pText = FormatContextText(Record.m_pMessage, { reinterpret_cast<const std::byte*>(Record.m_Text), Record.m_TextLength }
+                                                     , &Buffer[offsetof(info_construct<1>, m_Message)], sizeof(Buffer) - offsetof(info_construct<1>, m_Message) - 1 );
+                const auto& Info  = GetInfo(pText);
+                Message = { pText, static_cast<std::size_t>(Info.m_HintOffset + Info.m_HintLength) };
+            }
+
+            pCallback(Record.m_pStateName, Record.m_State, Message, Record.m_Line, Record.m_pFile);
+        }
+    }
+
+    //------------------------------------------------------------------------------------
+    // For a sink started without a drain thread (or stopped): each ring has a single consumer,
+    // so the user thread must not drain while the drain thread exists
+    inline std::size_t async_sink::Drain(void) noexcept
+    {
+        assert(m_Thread.joinable() == false && "xerr async_sink::Drain called while the drain thread runs");
+        return DrainRings();
+    }
+
+    //------------------------------------------------------------------------------------
+    // Delivers every pending record and releases the rings of dead threads. It runs on the
+    // drain thread, or on the user thread through Drain and Stop
+    inline std::size_t async_sink::DrainRings(void) noexcept
+    {
+        std::size_t nRecords = 0;
+        sink_ring*  pPrev    = nullptr;
+
+        for (auto* pRing = m_pRings.load(std::memory_order_acquire); pRing; )
+        {
+            // Check the death first so that the head we read afterwards is final
+            const bool bDead = pRing->m_bDead.load(std::memory_order_acquire);
+            const auto Head  = pRing->m_Head.load(std::memory_order_acquire);
+            auto       Tail  = pRing->m_Tail.load(std::memory_order_relaxed);
+
+            for (; Tail != Head; ++Tail, ++nRecords)
+            {
+                Deliver(pRing->m_Records[Tail & (sink_ring::size_v - 1)]);
+                pRing->m_Tail.store(Tail + 1, std::memory_order_release);
+            }
+
+            auto* pNext = pRing->m_pNext;
+            if (bDead)
+            {
+                // Producers only ever push at the head of the list
+                sink_ring* pExpected = pRing;
+                if (pPrev)
+                {
+                    pPrev->m_pNext = pNext;
+                }
+                else if (m_pRings.compare_exchange_strong(pExpected, pNext, std::memory_order_acq_rel) == false)
+                {
+                    pPrev = pExpected;
+                    while (pPrev->m_pNext != pRing) pPrev = pPrev->m_pNext;
+                    pPrev->m_pNext = pNext;
+                }
+                delete pRing;
+            }
+            else
+            {
+                pPrev = pRing;
+            }
+
+            pRing = pNext;
+        }
+
+        return nRecords;
+    }
+}
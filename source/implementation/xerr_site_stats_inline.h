@@ -0,0 +1,177 @@
+#include "xerr_clock_inline.h"
+
+#include <algorithm>
+#include <new>
+
+namespace xerr_details
+{
+    //------------------------------------------------------------------------------------
+    // SITE STATS
+    //------------------------------------------------------------------------------------
+
+    thread_local inline thread_counters_owner g_StatsCounters = {};
+
+    //------------------------------------------------------------------------------------
+    // When a thread dies its counters (and what they counted) go to the next thread
+    inline thread_counters_owner::~thread_counters_owner(void) noexcept
+    {
+        if (m_pCounters) m_pCounters->m_bTaken.store(false, std::memory_order_release);
+        m_pCounters = nullptr;
+    }
+
+    //------------------------------------------------------------------------------------
+
+    inline void site_stats::Hit(const char* pMessage) noexcept
+    {
+        if (m_bRegistered.load(std::memory_order_relaxed) == false && m_bRegistered.exchange(true, std::memory_order_acq_rel) == false)
+        {
+            m_pMessage = pMessage;
+            g_SiteStats.Register(*this);
+        }
+
+        // Only this thread writes its counter, the readers just need the store to be atomic.
+        // A site another thread is still registering has no slot yet and uses the shared one
+        const auto iSlot     = m_iSlot.load(std::memory_order_relaxed);
+        auto*      pCounters = iSlot < slots_v ? g_SiteStats.getCounters() : nullptr;
+        if (pCounters)
+        {
+            auto& Count = pCounters->m_Count[iSlot];
+            Count.store(Count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+        else
+        {
+            m_Shared.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    //------------------------------------------------------------------------------------
+
+    inline std::uint64_t site_stats::getCount(void) const noexcept
+    {
+        std::uint64_t Count = m_Shared.load(std::memory_order_relaxed);
+        const auto    iSlot = m_iSlot.load(std::memory_order_relaxed);
+        if (iSlot < slots_v)
+        {
+            for (auto* pCounters = g_SiteStats.m_pCounters.load(std::memory_order_acquire); pCounters; pCounters = pCounters->m_pNext)
+                Count += pCounters->m_Count[iSlot].load(std::memory_order_relaxed);
+        }
+        return Count;
+    }
+
+    //------------------------------------------------------------------------------------
+    // Counters of the calling thread: the block it already has, one a dead thread left or a
+    // new one. nullptr when the allocation fails, the caller then uses the shared counter
+    inline thread_counters* site_registry::getCounters(void) noexcept
+    {
+        auto& Owner = g_StatsCounters;
+        if (Owner.m_pCounters) return Owner.m_pCounters;
+
+        for (auto* pCounters = m_pCounters.load(std::memory_order_acquire); pCounters; pCounters = pCounters->m_pNext)
+        {
+            bool bTaken = false;
+            if (pCounters->m_bTaken.load(std::memory_order_relaxed) == false && pCounters->m_bTaken.compare_exchange_strong(bTaken, true, std::memory_order_acquire))
+                return Owner.m_pCounters = pCounters;
+        }
+
+        auto* pCounters = new (std::nothrow) thread_counters;
+        if (pCounters == nullptr) return nullptr;
+
+        pCounters->m_pNext = m_pCounters.load(std::memory_order_relaxed);
+        while (!m_pCounters.compare_exchange_weak(pCounters->m_pNext, pCounters, std::memory_order_release, std::memory_order_relaxed)) {}
+        return Owner.m_pCounters = pCounters;
+    }
+
+    //------------------------------------------------------------------------------------
+    // Gives the site its slot (or none when they ran out) and adds it to the list
+    inline void site_registry::Register(site_stats& Site) noexcept
+    {
+        Site.m_iSlot.store(m_nSlots.fetch_add(1, std::memory_order_relaxed), std::memory_order_relaxed);
+        Site.m_pNext = m_pHead.load(std::memory_order_relaxed);
+        while (!m_pHead.compare_exchange_weak(Site.m_pNext, &Site, std::memory_order_release, std::memory_order_relaxed)) {}
+    }
+
+    //------------------------------------------------------------------------------------
+
+    template< typename T_CALLBACK > inline
+    void site_registry::ForEach(T_CALLBACK&& Callback) const noexcept
+    {
+        for (auto* pSite = m_pHead.load(std::memory_order_acquire); pSite; pSite = pSite->m_pNext)
+            Callback(*pSite);
+    }
+
+    //------------------------------------------------------------------------------------
+    // Adds a point to the history of every site, call it periodically (ex: once a second)
+    // so TopN can compute counts and rates for a window
+    inline void site_registry::Sample(void) noexcept
+    {
+        const auto Now = SteadyNow();
+        ForEach([&](site_stats& Site)
+        {
+            Site.m_Samples[Site.m_nSamples++ % site_stats::samples_v] = { Now, Site.getCount() };
+        });
+    }
+
+    //------------------------------------------------------------------------------------
+    // Fills Out with the sites that fired the most, sorted from the top. With a zero Window
+    // the totals are used, otherwise the counts since the oldest sample inside the window
+    inline std::size_t site_registry::TopN(std::span<site_report> Out, std::chrono::nanoseconds Window) noexcept
+    {
+        const auto  Now     = SteadyNow();
+        const auto  Start   = Now - std::min<std::uint64_t>(Now, static_cast<std::uint64_t>(Window.count()));
+        std::size_t nOut    = 0;
+
+        if (Out.empty()) return 0;
+
+        ForEach([&](site_stats& Site)
+        {
+            site_report Report{ Site.m_pMessage, Site.getCount(), 0, 0 };
+
+            if (Window.count() == 0)
+            {
+                Report.m_WindowCount = Report.m_Count;
+            }
+            else
+            {
+                // The oldest sample that is still inside the window is our base line
+                const site_stats::sample* pBase = nullptr;
+                const auto nSamples = std::min<std::size_t>(Site.m_nSamples, site_stats::samples_v);
+                for (std::size_t i = 0; i < nSamples; ++i)
+                {
+                    const auto& Sample = Site.m_Samples[i];
+                    if (Sample.m_Timestamp >= Start && (pBase == nullptr || Sample.m_Timestamp < pBase->m_Timestamp)) pBase = &Sample;
+                }
+
+                if (pBase)
+                {
+                    Report.m_WindowCount = Report.m_Count - pBase->m_Count;
+                    if (Now > pBase->m_Timestamp) Report.m_Rate = static_cast<double>(Report.m_WindowCount) * 1e9 / static_cast<double>(Now - pBase->m_Timestamp);
+                }
+            }
+
+            // Insertion into the sorted output
+            std::size_t i = nOut < Out.size() ? nOut++ : Out.size();
+            if (i == Out.size())
+            {
+                if (Out.back().m_WindowCount >= Report.m_WindowCount) return;
+                --i;
+            }
+            for (; i > 0 && Out[i - 1].m_WindowCount < Report.m_WindowCount; --i) Out[i] = Out[i - 1];
+            Out[i] = Report;
+        });
+
+        return nOut;
+    }
+
+    //------------------------------------------------------------------------------------
+
+    template <string_literal T_STR_V, auto T_STATE_V>
+    inline site_stats site_stats_v = {};
+
+    //------------------------------------------------------------------------------------
+    // Called by ReportError for every error of the site (declared in xerr_inline.h)
+    template< string_literal T_STR_V, auto T_STATE_V >
+    inline void HitSite(void) noexcept
+    {
+        site_stats_v<T_STR_V, T_STATE_V>.Hit(data_v<T_STR_V, T_STATE_V>.m_Message);
+    }
+}
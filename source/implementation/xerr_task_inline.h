@@ -0,0 +1,167 @@
+#include <cassert>
+#include <cstdlib>
+#include <utility>
+
+namespace xerr_details
+{
+    //------------------------------------------------------------------------------------
+    // TASK PROMISE
+    //------------------------------------------------------------------------------------
+
+    inline void task_promise_base::unhandled_exception(void) const noexcept
+    {
+        // Tasks are exception free, an exception escaping one is a bug
+        assert(false && "exception thrown inside an xerr::task");
+        std::abort();
+    }
+
+    //------------------------------------------------------------------------------------
+    // Called when the task finishes. An error goes up to the awaiting task when it asked for
+    // short circuiting, which then finishes as well. Returns the coroutine to continue with.
+    // m_bDone is set last: once it is seen another thread may destroy the frame
+    inline std::coroutine_handle<> task_promise_base::Complete(void) noexcept
+    {
+        if (m_Error && m_pParent)
+        {
+            auto& Parent = *m_pParent;
+            Parent.m_Error = std::move(m_Error);
+            m_bDone.store(true, std::memory_order_release);
+            return Parent.Complete();
+        }
+
+        const auto Next = m_Continuation ? m_Continuation : std::noop_coroutine();
+        m_bDone.store(true, std::memory_order_release);
+        return Next;
+    }
+
+    //------------------------------------------------------------------------------------
+
+    inline task_promise_base::error_awaiter<void> task_promise_base::await_transform(xerr Error) noexcept
+    {
+        return { Error, this };
+    }
+
+    //------------------------------------------------------------------------------------
+
+    template< typename T > inline
+    task_promise_base::error_awaiter<T> task_promise_base::await_transform(xerr::result<T> Result) noexcept
+    {
+        return { std::move(Result), this };
+    }
+
+    //------------------------------------------------------------------------------------
+
+    template< typename T > inline
+    bool task_promise_base::error_awaiter<T>::await_ready(void) const noexcept
+    {
+        if constexpr (std::is_void_v<T>) return !m_Result;
+        else                             return m_Result.hasValue();
+    }
+
+    //------------------------------------------------------------------------------------
+    // The error was just created on this thread, so its chain is the thread chain
+    template< typename T > inline
+    std::coroutine_handle<> task_promise_base::error_awaiter<T>::await_suspend(std::coroutine_handle<>) noexcept
+    {
+        if constexpr (std::is_void_v<T>) m_pPromise->m_Error = xerr::owned{ m_Result };
+        else                             m_pPromise->m_Error = xerr::owned{ m_Result.getError() };
+        return m_pPromise->Complete();
+    }
+
+    //------------------------------------------------------------------------------------
+
+    template< typename T > inline
+    T task_promise_base::error_awaiter<T>::await_resume(void) noexcept
+    {
+        if constexpr (std::is_void_v<T> == false) return std::move(m_Result).getValue();
+    }
+
+    //------------------------------------------------------------------------------------
+
+    template< typename T > inline
+    void task_promise<T>::return_value(xerr::result<T> Result) noexcept
+    {
+        if (Result) m_Value.emplace(std::move(Result).getValue());
+        else        m_Error = xerr::owned{ Result.getError() };
+    }
+
+}
+
+//------------------------------------------------------------------------------------
+// TASK
+//------------------------------------------------------------------------------------
+
+template< typename T > inline
+xerr::task<T>& xerr::task<T>::operator = (task&& Other) noexcept
+{
+    if (this != &Other)
+    {
+        if (m_Handle) m_Handle.destroy();
+        m_Handle = std::exchange(Other.m_Handle, nullptr);
+    }
+    return *this;
+}
+
+//------------------------------------------------------------------------------------
+// Runs the task until its first suspension, for top level tasks that nobody awaits
+template< typename T > inline
+void xerr::task<T>::Start(void) noexcept
+{
+    assert(m_Handle && isDone() == false);
+    m_Handle.resume();
+}
+
+//------------------------------------------------------------------------------------
+// Result of a finished task. The error chain is installed on the calling thread
+template< typename T > inline
+typename xerr::task<T>::result_type xerr::task<T>::getResult(void) noexcept
+{
+    assert(isDone());
+
+    auto& Promise = m_Handle.promise();
+    if (Promise.m_Error) return Promise.m_Error.Resume();
+    if constexpr (std::is_void_v<T>) return {};
+    else                             return Promise.TakeValue();
+}
+
+//------------------------------------------------------------------------------------
+
+template< typename T > template< typename T_PROMISE > inline
+std::coroutine_handle<> xerr::task<T>::awaiter::await_suspend(std::coroutine_handle<T_PROMISE> Awaiting) noexcept
+{
+    static_assert(std::is_base_of_v<xerr_details::task_promise_base, T_PROMISE>, "co_await of an xerr::task needs an xerr::task to short circuit, use AsResult() elsewhere");
+
+    auto& Promise = m_Handle.promise();
+    Promise.m_Continuation = Awaiting;
+    Promise.m_pParent      = &Awaiting.promise();
+    return m_Handle;
+}
+
+//------------------------------------------------------------------------------------
+// Only reached when the task returned a value, errors never resume the awaiting task
+template< typename T > inline
+T xerr::task<T>::awaiter::await_resume(void) noexcept
+{
+    assert(!m_Handle.promise().m_Error);
+    return m_Handle.promise().TakeValue();
+}
+
+//------------------------------------------------------------------------------------
+
+template< typename T > inline
+std::coroutine_handle<> xerr::task<T>::result_awaiter::await_suspend(std::coroutine_handle<> Awaiting) noexcept
+{
+    m_Handle.promise().m_Continuation = Awaiting;
+    return m_Handle;
+}
+
+//------------------------------------------------------------------------------------
+
+template< typename T > inline
+typename xerr::task<T>::result_type xerr::task<T>::result_awaiter::await_resume(void) noexcept
+{
+    auto& Promise = m_Handle.promise();
+    if (Promise.m_Error) return Promise.m_Error.Resume();
+    if constexpr (std::is_void_v<T>) return {};
+    else                             return Promise.TakeValue();
+}
@@ -4,8 +4,15 @@
 
 #include <array>
 #include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
 #include <string>
+#include <string_view>
 #include <source_location>
+#include <span>
 
 //-----------------------------------------------------------------------------------------
 // XERR DETAILS
@@ -21,22 +28,372 @@ namespace xerr_details
 
     //------------------------------------------------------------------------------------
 
+    // Total number of chain nodes. In segmented mode this is the maximum the pool can grow to
+#ifndef XERR_CHAIN_POOL_SIZE
+    #define XERR_CHAIN_POOL_SIZE 1024
+#endif
+
+    // When defined to a power of two the pool starts empty and grows on demand in segments
+    // of this many nodes. Segments are never moved or released while the process runs
+    // so node indices held by chains stay valid. Note that growing calls the memory manager.
+#ifndef XERR_CHAIN_POOL_SEGMENT_SIZE
+    #define XERR_CHAIN_POOL_SEGMENT_SIZE 0
+#endif
+
+    // Number of free node indices each thread keeps cached before touching the global list.
+    // Setting it to 0 disables the per-thread cache (every Alloc/Free goes to the global list)
+#ifndef XERR_CHAIN_MAGAZINE_SIZE
+    #define XERR_CHAIN_MAGAZINE_SIZE 16
+#endif
+
+    // Nodes keep the message as a 32-bit offset from the pool, which halves them (8 bytes with
+    // 16-bit indices). Messages too far away (other shared libraries) go into a table of this
+    // many slots (power of two). 0 keeps full pointers in the nodes
+#ifndef XERR_CHAIN_FAR_SIZE
+    #define XERR_CHAIN_FAR_SIZE 1024
+#endif
+
     struct chain_pool
     {
+        constexpr static std::size_t  capacity_v       = XERR_CHAIN_POOL_SIZE;
+        constexpr static std::size_t  segment_size_v   = XERR_CHAIN_POOL_SEGMENT_SIZE;
+        constexpr static bool         segmented_v      = segment_size_v != 0;
+        constexpr static std::int16_t magazine_size_v  = XERR_CHAIN_MAGAZINE_SIZE;
+        constexpr static std::int16_t magazine_batch_v = magazine_size_v / 2 ? magazine_size_v / 2 : 1;
+        constexpr static std::size_t  far_size_v       = XERR_CHAIN_FAR_SIZE;
+        constexpr static bool         compact_v        = far_size_v != 0;
+        constexpr static std::size_t  cache_line_v     = 64;
+
+        static_assert(capacity_v > 0 && capacity_v <= 0x7fffffff, "XERR_CHAIN_POOL_SIZE out of range");
+        static_assert(segmented_v == false || ((segment_size_v & (segment_size_v - 1)) == 0 && (capacity_v % segment_size_v) == 0), "XERR_CHAIN_POOL_SEGMENT_SIZE must be a power of two that divides XERR_CHAIN_POOL_SIZE");
+        static_assert((far_size_v & (far_size_v - 1)) == 0 && far_size_v <= 0x40000000, "XERR_CHAIN_FAR_SIZE must be a power of two");
+
+        // Node indices only grow to 32 bits when the capacity requires it
+        using index = std::conditional_t< (capacity_v <= 0x7fff), std::int16_t, std::int32_t >;
+        using head  = std::conditional_t< sizeof(index) == 2, std::uint32_t, std::uint64_t >;
+
+        // What to do when a chain needs a node and the pool has none left
+        enum class exhaustion_policy : std::uint8_t
+        { TRUNCATE_OLDEST   // Recycle the oldest cause of the chain that is growing
+        , DROP_NEW          // Leave the chain as it is and drop the new link
+        , FAIL_FAST         // Abort the process
+        };
+
+        // Message of a node: odd values are the offset of the message from the pool (messages
+        // are odd, see info_construct), even values are twice the slot of a far message
+        using error_ref = std::conditional_t< compact_v, std::int32_t, const char* >;
+
+        constexpr static std::int32_t   invalid_ref_v = std::numeric_limits<std::int32_t>::min();
+
         struct node
         {
-            const char*  m_pError;  // Store XErr directly
-            std::int16_t m_iNext;   // Index to next node (-1 for end)
-            std::int16_t m_iPrev;   // Index to previous node (-1 for end)
+            error_ref    m_Error;   // Use chain_pool::getError/MakeRef
+            index        m_iNext;   // Index to next node (-1 for end)
+            index        m_iPrev;   // Index to previous node (-1 for end)
+        };
+
+        // Per-thread cache of free nodes. It refills from and spills to the global list
+        // in batches of magazine_batch_v so the common chain/unchain cycle stays thread local.
+        // The owner flags it busy while it uses it, so Reclaim can empty the magazines of idle
+        // threads. Only plain stores on the owner side, see Enter and ProcessBarrier
+        struct alignas(cache_line_v) magazine
+        {
+            std::atomic<bool>                                           m_bTaken    { false };  // Owned by a thread
+            std::atomic<bool>                                           m_bBusy     { false };  // In use by the owner
+            std::atomic<bool>                                           m_bReclaim  { false };  // Being emptied by Reclaim, the owner uses the global list
+            std::int16_t                                                m_Count     = 0;
+            std::array<index, magazine_size_v ? magazine_size_v : 1>    m_Index;
         };
 
+        // Magazine of the calling thread, handed back (with its nodes) when the thread exits
+        struct magazine_owner
+        {
+            inline                 ~magazine_owner  (void)                                      noexcept;
+
+            magazine*                   m_pMagazine     = nullptr;
+            std::uint32_t               m_nReleases     = ~std::uint32_t{ 0 };  // chain_pool::m_nReleases of the last failed claim
+        };
+
+        // Together the magazines hold at most a quarter of the pool, threads past that use the global list
+        constexpr static std::size_t  magazine_count_v = []() consteval noexcept -> std::size_t
+        {
+            constexpr std::size_t Limit = capacity_v / 4 / (magazine_size_v ? magazine_size_v : 1);
+            return magazine_size_v == 0 ? 0 : Limit < 256 ? Limit : 256;
+        }();
+
+        // The free list head packs the node index (low bits) with a generation tag (high bits)
+        // which changes on every push/pop, so a CAS can not succeed on a recycled (ABA) head
+        constexpr static int            index_bits_v = sizeof(index) * 8;
+        constexpr static head           Pack        ( index Index, head Tag )                       noexcept { return (Tag << index_bits_v) | static_cast<std::make_unsigned_t<index>>(Index); }
+        constexpr static index          UnpackIndex ( head Head )                                   noexcept { return static_cast<index>(static_cast<std::make_unsigned_t<index>>(Head)); }
+        constexpr static head           UnpackTag   ( head Head )                                   noexcept { return Head >> index_bits_v; }
+
         inline                  chain_pool  (void)                                          noexcept;
-        inline std::int16_t     Alloc       (void)                                          noexcept;
-        inline void             Free        ( std::int16_t& iHead, std::int16_t& iTail )    noexcept;
+        inline                 ~chain_pool  (void)                                          noexcept;
+        inline node&            operator[]  ( index Index )                                 noexcept;
+        inline const node&      operator[]  ( index Index )                         const   noexcept;
+        inline index            Alloc       (void)                                          noexcept;
+        inline void             Free        ( index& iHead, index& iTail )                  noexcept;
+        inline int              PopBatch    ( index* pIndex, int Count )                    noexcept;
+        inline void             PushBatch   ( index iFirst, index iLast )                   noexcept;
+        inline bool             Grow        (void)                                          noexcept;
+        inline magazine*        getMagazine (void)                                          noexcept;
+        inline bool             Enter       ( magazine& Magazine )                          noexcept;
+        inline static void      Leave       ( magazine& Magazine )                          noexcept;
+        inline void             Spill       ( magazine& Magazine, std::int16_t Count )      noexcept;
+        inline bool             Reclaim     (void)                                          noexcept;
+        inline index            Exhausted   ( index& iHead, index& iTail )                  noexcept;
+        inline error_ref        MakeRef     ( const char* pError )                          noexcept;
+        inline const char*      getError    ( index Index )                         const   noexcept;
+
+#if XERR_CHAIN_POOL_SEGMENT_SIZE
+        constexpr static int            segment_shift_v = std::countr_zero(segment_size_v);
+        std::array<std::atomic<node*>, capacity_v / segment_size_v> m_Segments  = {};
+        std::atomic<std::uint32_t>      m_nSegments         { 0 };
+#else
+        std::array<node, capacity_v>    m_Pool;
+#endif
+        // The free list head has a cache line of its own, so the CAS traffic does not slow down
+        // threads walking the nodes next to it
+        alignas(cache_line_v) std::atomic<head> m_Empty{ Pack(-1, 0) };
+
+        // Exhaustion handling, the policy is meant to be set once at startup
+        alignas(cache_line_v) exhaustion_policy m_ExhaustionPolicy  = exhaustion_policy::TRUNCATE_OLDEST;
+        std::atomic<std::uint64_t>      m_TruncateCount     { 0 };
+        std::atomic<std::uint64_t>      m_DropCount         { 0 };      // Also counts links dropped because the far table was full
+        std::atomic<std::uint64_t>      m_FailFastCount     { 0 };
+        bool                            m_bAsymmetric       = false;    // ProcessBarrier works, magazine owners skip the fence
+        std::atomic<bool>               m_bReclaiming       { false };  // One Reclaim at a time
+
+        // Thread caches, a thread takes a free one the first time it needs a node
+        std::array<magazine, magazine_count_v ? magazine_count_v : 1>   m_Magazines;
+        std::atomic<std::uint32_t>      m_nReleases         { 0 };      // Magazines handed back by exiting threads
+        std::atomic<std::uint64_t>      m_ReclaimCount      { 0 };      // Nodes taken back from the magazines when the pool ran dry
+
+        // Messages out of reach of a 32-bit offset, slots are taken once and never released
+        std::array<std::atomic<const char*>, compact_v ? far_size_v : 1>  m_Far = {};
+    };
+
+    //------------------------------------------------------------------------------------
+
+    // Bytes of runtime context each thread keeps for its latest errors (0 disables the capture)
+#ifndef XERR_CONTEXT_ARENA_SIZE
+    #define XERR_CONTEXT_ARENA_SIZE 4096
+#endif
+
+    // Runtime argument of an error (see xerr::args), replaces a {} of the message when formatted
+    struct context_arg
+    {
+        enum class kind : std::uint8_t
+        { SIGNED
+        , UNSIGNED
+        , POINTER
+        , STRING
+        };
+
+        kind                m_Kind;
+        std::uint64_t       m_Value;            // Integers and pointers
+        std::string_view    m_String;           // Copied into the arena when the error is created
+    };
+
+    template< std::size_t T_COUNT_V >
+    struct context_args
+    {
+        std::array<context_arg, T_COUNT_V>  m_Args;
+    };
+
+    // Per-thread ring where errors keep their arguments, serialized as { u8 kind, u64 value } or
+    // { u8 kind, u8 length, chars }. The text is only formatted when someone asks for the message,
+    // and an entry lives until newer entries of the same thread wrap around it.
+    struct context_arena
+    {
+        constexpr static std::size_t    size_v          = XERR_CONTEXT_ARENA_SIZE;
+        constexpr static std::uint64_t  none_v          = 0;
+        constexpr static std::size_t    max_string_v    = 255;
+
+        struct entry
+        {
+            inline std::span<const std::byte>   getArgs     (void)                          const   noexcept;
+            inline const char*                  getText     (void)                                  noexcept;
+
+            std::uint64_t       m_iPrev;            // Position + 1 of the previous entry (none_v for none)
+            const char*         m_pMessage;         // Error (data_v) the arguments belong to
+            std::uint16_t       m_Size;             // Bytes of the entry
+            std::uint16_t       m_ArgsSize;         // Serialized arguments, right after this header
+            std::uint16_t       m_TextOffset;       // Offset of the text, which has an info_construct header in front
+            std::uint16_t       m_TextCapacity;     // Characters reserved for the text
+            bool                m_bFormatted;       // The text has been formatted
+        };
+
+        inline entry*           Capture     ( const char* pMessage, std::span<const context_arg> Args )         noexcept;
+        inline entry*           Find        ( const char* pMessage )                                            noexcept;
+
+        alignas(8) std::array<std::byte, size_v>    m_Data;
+        std::uint64_t                               m_Head      = 0;        // Bytes ever written, positions are monotonic
+        std::uint64_t                               m_iNewest   = none_v;   // Position + 1, so a new arena is all zeros (.tbss)
+    };
+
+    //------------------------------------------------------------------------------------
+
+    // Return addresses captured when an error is created, 0 disables the capture. The stack is
+    // walked through the frame pointers (build with -fno-omit-frame-pointer, or the walk stops
+    // early) and with RtlCaptureStackBackTrace on Windows
+#ifndef XERR_STACK_DEPTH
+    #define XERR_STACK_DEPTH 0
+#endif
+
+    // Stacks each thread keeps for its latest errors
+#ifndef XERR_STACK_SLOTS
+    #define XERR_STACK_SLOTS 64
+#endif
+
+    // Per-thread ring of raw stacks. Nothing is allocated or symbolized when an error is created,
+    // see xerr::getStack and xerr::Symbolize for the rest
+    struct stack_pool
+    {
+        constexpr static std::size_t    depth_v         = XERR_STACK_DEPTH;
+        constexpr static std::size_t    slots_v         = XERR_STACK_SLOTS;
+        constexpr static std::uintptr_t max_frame_v     = 1024 * 1024;      // Larger jumps between frame pointers end the walk
+
+        static_assert(depth_v <= 255 && slots_v > 0, "XERR_STACK_DEPTH/XERR_STACK_SLOTS out of range");
+
+        struct slot
+        {
+            const char*                                 m_pMessage;     // Error (data_v) the stack belongs to
+            std::uint32_t                               m_Depth;
+            std::array<void*, depth_v>                  m_Frames;       // Return addresses, the create call site first
+        };
+
+        inline void                     Capture     ( const char* pMessage )                            noexcept;
+        inline const slot*              Find        ( const char* pMessage )                    const   noexcept;
+
+        std::array<slot, slots_v>       m_Slots;
+        std::uint64_t                   m_Count     = 0;                // Stacks ever captured
+    };
+
+    //------------------------------------------------------------------------------------
+
+    using fn_error_callback = void(const char* pEnumValue, std::uint8_t State, std::string_view Message, std::uint32_t Line, std::string_view file );
+
+    // Where create<> and LogMessage hand their report while the async sink runs (see xerr_sink.h). Text is the
+    // LogMessage text or the serialized arguments of the error, at most sink_text_size_v bytes are kept
+    using fn_sink_push = void(const char* pStateName, std::uint8_t State, const char* pMessage, std::string_view Text, const char* pFile, std::uint32_t Line);
+    constexpr static std::size_t sink_text_size_v = 90;
+
+    // Set to 0 to compile out the reporting (callback, async sink, locations and state names) of every state.
+    // To filter only some states specialize xerr::report_policy instead
+#ifndef XERR_REPORTING
+    #define XERR_REPORTING 1
+#endif
+
+    // Stands in for std::source_location in the create/LogMessage of states that are not reported,
+    // so their call sites do not emit the file and function names
+    struct no_location
+    {
+        consteval static no_location current(void) noexcept { return {}; }
+    };
+
+    //------------------------------------------------------------------------------------
+
+    // Define to 1 to count how many times each error site (each distinct data_v) fires
+#ifndef XERR_SITE_STATS
+    #define XERR_SITE_STATS 0
+#endif
+
+    //------------------------------------------------------------------------------------
+
+    // Reports per second each error site can send to the callback or the async sink, 0 for no limit.
+    // A site over its budget only counts what it suppressed, the count is reported later as a summary
+#ifndef XERR_REPORT_RATE
+    #define XERR_REPORT_RATE 0
+#endif
+
+    struct site_limiter;
+
+    //------------------------------------------------------------------------------------
+
+    // Define to 1 to compile in the flight recorder (see xerr_details::g_FlightRecorder)
+#ifndef XERR_FLIGHT_RECORDER
+    #define XERR_FLIGHT_RECORDER 0
+#endif
 
-        std::array<node, 1024>      m_Pool;
-        std::atomic<std::int16_t>   m_iEmpty{ -1 };
+    //------------------------------------------------------------------------------------
+
+    // Slots of the catalog lookup table (power of two), 0 makes Find a linear search
+#ifndef XERR_CATALOG_INDEX_SIZE
+    #define XERR_CATALOG_INDEX_SIZE 4096
+#endif
+
+    // One entry per error site, registered during static initialization (or dlopen)
+    struct catalog_entry
+    {
+        inline                          catalog_entry   ( std::uint64_t ID, std::uint64_t TypeHash, const char* pMessage, const char* pStateName ) noexcept;
+
+        std::uint64_t                   m_ID;                       // Stable site ID (see create_site_id)
+        std::uint64_t                   m_TypeHash;                 // Hash of the enum name that went into m_ID, the same on every compiler
+        const char*                     m_pMessage;                 // Message of the site, xerr{ m_pMessage } gives the rest
+        const char*                     m_pStateName;               // "Enum::VALUE" from the state name table of the enum
+        catalog_entry*                  m_pNext = nullptr;
+        mutable std::atomic<bool>       m_bCollided { false };      // Another site with this ID was refused, compare what the ID was made of
     };
+
+    // Enumerable catalog of every error the process can produce
+    struct catalog
+    {
+        constexpr static std::size_t    index_size_v = XERR_CATALOG_INDEX_SIZE;
+        static_assert((index_size_v & (index_size_v - 1)) == 0, "XERR_CATALOG_INDEX_SIZE must be a power of two");
+
+        inline void                     Register    ( catalog_entry& Entry )                        noexcept;
+        inline const catalog_entry*     Find        ( std::uint64_t ID )                    const   noexcept;
+        inline const catalog_entry*     FindSite    ( const char* pMessage )                const   noexcept;
+        inline static bool              isSameSite  ( const catalog_entry& A, const catalog_entry& B )      noexcept;
+        inline bool                     isSameSite  ( const char* pA, const char* pB )          const   noexcept;
+        template< typename T_CALLBACK >
+        inline void                     ForEach     ( T_CALLBACK&& Callback )               const   noexcept;
+
+        std::atomic<catalog_entry*>                                             m_pHead     { nullptr };
+        std::atomic<catalog_entry*>                                             m_pRefused  { nullptr };    // Sites that collided, kept so FindSite knows them
+        std::atomic<std::uint32_t>                                              m_Count     { 0 };
+        std::atomic<std::uint32_t>                                              m_nCollisions { 0 };    // Different sites with the same ID
+        std::array<std::atomic<catalog_entry*>, index_size_v ? index_size_v : 1> m_Index    = {};
+    };
+
+    //------------------------------------------------------------------------------------
+
+    // Packed state name table of an enum (see state_names), registered the first time one of its states is reported
+    struct state_name_entry
+    {
+        inline                          state_name_entry    ( std::uint32_t UID, const char* pNames, std::uint16_t Size, const std::uint16_t* pOffset, std::uint16_t Count ) noexcept;
+        inline std::string_view         getName             ( std::uint8_t State )                  const   noexcept;
+
+        std::uint32_t                   m_UID;                      // uid_v of the enum, the key of the table
+        std::uint16_t                   m_Size;                     // Bytes of m_pNames
+        std::uint16_t                   m_Count;                    // Entries of m_pOffset
+        const char*                     m_pNames;                   // "Enum::VALUE\0Enum::OTHER\0..."
+        const std::uint16_t*            m_pOffset;                  // Offset of the name of each state byte, 0xffff for none
+        state_name_entry*               m_pNext = nullptr;
+    };
+
+    // State names of every reported enum by type UID, so any error can name its state
+    struct state_name_registry
+    {
+        constexpr static std::size_t    index_size_v = 256;
+
+        inline void                     Register    ( state_name_entry& Entry )                     noexcept;
+        inline const state_name_entry*  Find        ( std::uint32_t UID )                   const   noexcept;
+
+        std::atomic<state_name_entry*>                              m_pHead         { nullptr };
+        std::atomic<std::uint32_t>                                  m_nCollisions   { 0 };      // Different enums with the same UID
+        std::array<std::atomic<state_name_entry*>, index_size_v>    m_Index         = {};
+    };
+
+    //------------------------------------------------------------------------------------
+
+    // Handlers of xerr::Match (see xerr::on and xerr::otherwise). any_state_v handles every state of the enum
+    constexpr std::uint32_t any_state_v = 0x100;
+
+    template< typename T_STATE_ENUM, std::uint32_t T_STATE_V, typename T_CALLBACK > struct match_case;
+    template< typename T_CALLBACK > struct match_otherwise;
 }
 
 //-----------------------------------------------------------------------------------------
@@ -46,7 +403,29 @@ namespace xerr_details
 struct xerr
 {
     // Debugging callback for logging and special handling
-    using fn_error_callback = void(const char* pEnumValue, std::uint8_t State, std::string_view Message, std::uint32_t Line, std::string_view file );
+    using fn_error_callback = xerr_details::fn_error_callback;
+
+    // Compile-time reporting filter. Specialize it for a state enum to strip the reporting of some states:
+    //
+    //      template<> struct xerr::report_policy<my_states>
+    //      {
+    //          constexpr static bool isReported(my_states State) noexcept { return State != my_states::NOT_FOUND; }
+    //      };
+    //
+    // A filtered state has no callback/sink branch, no source_location and no state name string in the binary.
+    // The specialization must be visible before the first create of that enum
+    template< typename T_STATE_ENUM >
+    struct report_policy
+    {
+        constexpr static bool isReported(T_STATE_ENUM) noexcept { return true; }
+    };
+
+    template< auto T_STATE_V >
+    constexpr static bool is_reported_v = XERR_REPORTING != 0 && report_policy<decltype(T_STATE_V)>::isReported(T_STATE_V);
+
+    // Location taken by create and LogMessage, empty for the states that are not reported
+    template< auto T_STATE_V >
+    using location = std::conditional_t< is_reported_v<T_STATE_V>, std::source_location, xerr_details::no_location >;
 
     // Handy object for cleaning up scopes that have errors
     template< typename T_CALLBACK> struct cleanup
@@ -57,6 +436,46 @@ struct xerr
         T_CALLBACK m_Lambda;
     };
 
+    // Error that owns its cause chain instead of sharing the thread's chain. It can be moved to another
+    // thread or coroutine and a new error on the original thread will not clobber it. Building one from
+    // an xerr takes the current thread chain when that chain belongs to the error (it is its latest link)
+    struct owned
+    {
+        using index = xerr_details::chain_pool::index;
+
+        constexpr               owned                   (void)                                          noexcept = default;
+        inline                  owned                   (xerr Error)                                    noexcept;
+        inline                  owned                   (owned&& Other)                                 noexcept;
+                                owned                   (const owned&)                                  = delete;
+        inline                 ~owned                   (void)                                          noexcept;
+        inline  owned&          operator =              (owned&& Other)                                 noexcept;
+                owned&          operator =              (const owned&)                                  = delete;
+
+        constexpr               operator bool           (void)                                  const   noexcept { return !!m_pMessage; }
+        constexpr   xerr        get                     (void)                                  const   noexcept { return { m_pMessage }; }
+        constexpr   bool        hasChain                (void)                                  const   noexcept { return m_iHead != -1; }
+        inline      void        clear                   (void)                                          noexcept;
+        inline      xerr        Resume                  (void)                                          noexcept;
+
+        template< typename T_CALLBACK>
+        inline      void        ForEachInChain          (T_CALLBACK&& Callback)                 const   noexcept requires std::invocable<T_CALLBACK, xerr>;
+        template< typename T_CALLBACK>
+        inline      void        ForEachInChainBackwards (T_CALLBACK&& Callback)                 const   noexcept requires std::invocable<T_CALLBACK, xerr>;
+
+        const char*             m_pMessage  = nullptr;  // Same as xerr::m_pMessage
+        index                   m_iHead     = -1;       // Latest link of the chain (-1 for no chain)
+        index                   m_iTail     = -1;       // Root cause of the chain (-1 for no chain)
+    };
+
+    // Value or error, returned the same way as an xerr (see the definition below)
+    template< typename T > struct result;
+
+    // Exception free coroutine returning a T or an xerr, see xerr_task.h
+    template< typename T = void > struct task;
+
+    // Failures of a data-parallel loop, collected per thread without locks, see xerr_batch.h
+    struct batch;
+
     // The default states for xerr. Please note that this could be customized per error class
     enum class default_states : std::uint8_t
     { OK        = 0
@@ -66,8 +485,17 @@ struct xerr
     };
 
     constexpr                                   operator bool               (void)                              const   noexcept;
+
+    // Identity of the error site: the same create<> compares equal even when each shared object has its own
+    // copy of the message. O(1) through the site ID, which the catalog checks for collisions as sites register
+    inline                  bool                operator ==                 (const xerr& Other)                 const   noexcept;
     inline                  void                clear                       (void)                                      noexcept;
     constexpr               std::uint32_t       getStateUID                 (void)                              const   noexcept;
+    inline                  std::uint64_t       getSiteID                   (void)                              const   noexcept;
+    inline                  std::string_view    getStateName                (void)                              const   noexcept;
+
+    template <auto T_STATE_V, xerr_details::string_literal T_STR_V>
+    consteval static        std::uint64_t       fromSiteID                  (void)                                      noexcept requires (std::is_enum_v<decltype(T_STATE_V)>);
 
     template< typename T_STATE_ENUM >
     consteval static        std::uint32_t       fromStateUID                (void)                                      noexcept requires (std::is_enum_v<T_STATE_ENUM>);
@@ -89,28 +517,183 @@ struct xerr
     template< typename T_STATE_ENUM >
     constexpr               T_STATE_ENUM        getState                    (void)                              const   noexcept requires (std::is_enum_v<T_STATE_ENUM>);
 
+    // Binary serialization of the error (and its chain) for IPC. The layout is fixed and little endian:
+    // header { u32 magic 'XERR', u8 version, u8 reserved, u16 link count } followed by, from the root cause
+    // to the latest error, link { u64 site ID, u8 state, u8 reserved[3] }
+    constexpr static        std::size_t         serial_header_size_v        = 8;
+    constexpr static        std::size_t         serial_link_size_v          = 12;
+    constexpr static        std::uint32_t       serial_magic_v              = 0x52524558;   // "XERR"
+    constexpr static        std::uint8_t        serial_version_v            = 1;
+
+    // Return addresses of the create call of this error (XERR_STACK_DEPTH), empty when disabled or when this
+    // thread no longer has them. Symbolize turns one into "function+0x12 (module+0x3456)"; the module
+    // relative address can be resolved offline (ex: addr2line -e module 0x3456)
+    inline                  std::span<void* const> getStack             (void)                              const   noexcept;
+    inline static           std::string_view    Symbolize                   (const void* pAddress, std::span<char> Buffer) noexcept;
+
+    // Layout of the text written by Format and FormatTo (and std::formatter<xerr>, see xerr_format.h)
+    enum class format_style : std::uint8_t
+    { TEXT          // One link per line, the latest first: "state: message (hint)" then "  caused by state: ..."
+    , LINE          // Same as TEXT on a single line, the links separated by " <- "
+    , JSON          // [{"state":"...","code":N,"message":"...","hint":"..."},...], the latest first
+    };
+
+    // The whole chain without allocating. bSite adds the site ID of each link. State names come from the catalog
+    template< typename T_OUT >
+    inline                  T_OUT               FormatTo                    (T_OUT Out, format_style Style = format_style::TEXT, bool bSite = false) const noexcept;
+    inline                  std::string_view    Format                      (std::span<char> Buffer, format_style Style = format_style::TEXT, bool bSite = false) const noexcept;
+
+    // Handlers for Match: on<State>(F) takes one state, on<Enum>(F) every other state of that enum (F gets the
+    // state) and otherwise(F) everything else. Handlers can take the xerr or nothing, and return void
+    template< auto T_STATE_V, typename T_CALLBACK >
+    constexpr static        xerr_details::match_case<decltype(T_STATE_V), static_cast<std::uint32_t>(T_STATE_V), std::decay_t<T_CALLBACK>>
+                                                on                          (T_CALLBACK&& Callback)                     noexcept requires (std::is_enum_v<decltype(T_STATE_V)>);
+    template< typename T_STATE_ENUM, typename T_CALLBACK >
+    constexpr static        xerr_details::match_case<T_STATE_ENUM, xerr_details::any_state_v, std::decay_t<T_CALLBACK>>
+                                                on                          (T_CALLBACK&& Callback)                     noexcept requires (std::is_enum_v<T_STATE_ENUM>);
+    template< typename T_CALLBACK >
+    constexpr static        xerr_details::match_otherwise<std::decay_t<T_CALLBACK>>
+                                                otherwise                   (T_CALLBACK&& Callback)                     noexcept;
+
+    // Routes the error to its handler: a binary search over the (enum UID, state) keys sorted at compile
+    // time and one indirect call. Returns false when nothing handled it (always for an empty error)
+    template< typename... T_CASES >
+    inline                  bool                Match                       (T_CASES&&... Cases)                const   noexcept;
+
+    inline                  std::size_t         getSerializedSize           (void)                              const   noexcept;
+    inline                  std::size_t         Serialize                   (std::span<std::byte> Buffer)       const   noexcept;
+    inline static           xerr                Deserialize                 (std::span<const std::byte> Buffer)         noexcept;
+
     template <auto T_STATE_V, xerr_details::string_literal T_STR_V>
-    constexpr static        xerr                create                      (const std::source_location loc = std::source_location::current())                          noexcept requires (std::is_enum_v<decltype(T_STATE_V)>);
+    constexpr static        xerr                create                      (const location<T_STATE_V> loc = location<T_STATE_V>::current())                          noexcept requires (std::is_enum_v<decltype(T_STATE_V)>);
 
     template <auto T_STATE_V, xerr_details::string_literal T_STR_V>
-    constexpr static        xerr                create                      (const xerr PrevError, const std::source_location loc = std::source_location::current())    noexcept requires (std::is_enum_v<decltype(T_STATE_V)>);
+    constexpr static        xerr                create                      (const xerr PrevError, const location<T_STATE_V> loc = location<T_STATE_V>::current())    noexcept requires (std::is_enum_v<decltype(T_STATE_V)>);
+
+    // Runtime arguments for the {} of the message: integers, enums, pointers and strings
+    template< typename... T_ARGS >
+    constexpr static        xerr_details::context_args<sizeof...(T_ARGS)> args ( const T_ARGS&... Args )                                                                noexcept;
+
+    template <auto T_STATE_V, xerr_details::string_literal T_STR_V, std::size_t T_COUNT_V>
+    inline static           xerr                create                      (const xerr_details::context_args<T_COUNT_V>& Args, const location<T_STATE_V> loc = location<T_STATE_V>::current())                          noexcept requires (std::is_enum_v<decltype(T_STATE_V)>);
+
+    template <auto T_STATE_V, xerr_details::string_literal T_STR_V, std::size_t T_COUNT_V>
+    inline static           xerr                create                      (const xerr PrevError, const xerr_details::context_args<T_COUNT_V>& Args, const location<T_STATE_V> loc = location<T_STATE_V>::current())  noexcept requires (std::is_enum_v<decltype(T_STATE_V)>);
 
     template <typename T_STATE_ENUM, xerr_details::string_literal T_STR_V>
-    constexpr static        xerr                create_f                    (const std::source_location loc = std::source_location::current())                          noexcept requires (std::is_enum_v<T_STATE_ENUM>);
+    constexpr static        xerr                create_f                    (const location<T_STATE_ENUM::FAILURE> loc = location<T_STATE_ENUM::FAILURE>::current())                          noexcept requires (std::is_enum_v<T_STATE_ENUM>);
 
     template <typename T_STATE_ENUM, xerr_details::string_literal T_STR_V>
-    constexpr static        xerr                create_f                    (const xerr PrevError, const std::source_location loc = std::source_location::current())    noexcept requires (std::is_enum_v<T_STATE_ENUM>);
+    constexpr static        xerr                create_f                    (const xerr PrevError, const location<T_STATE_ENUM::FAILURE> loc = location<T_STATE_ENUM::FAILURE>::current())    noexcept requires (std::is_enum_v<T_STATE_ENUM>);
+
+    template <typename T_STATE_ENUM, xerr_details::string_literal T_STR_V, std::size_t T_COUNT_V>
+    inline static           xerr                create_f                    (const xerr_details::context_args<T_COUNT_V>& Args, const location<T_STATE_ENUM::FAILURE> loc = location<T_STATE_ENUM::FAILURE>::current())                          noexcept requires (std::is_enum_v<T_STATE_ENUM>);
+
+    template <typename T_STATE_ENUM, xerr_details::string_literal T_STR_V, std::size_t T_COUNT_V>
+    inline static           xerr                create_f                    (const xerr PrevError, const xerr_details::context_args<T_COUNT_V>& Args, const location<T_STATE_ENUM::FAILURE> loc = location<T_STATE_ENUM::FAILURE>::current())  noexcept requires (std::is_enum_v<T_STATE_ENUM>);
 
     template <auto T_STATE_V>
-    constexpr static        void                LogMessage                  ( std::string_view Message, const std::source_location loc = std::source_location::current())noexcept requires (std::is_enum_v<decltype(T_STATE_V)>);
+    constexpr static        void                LogMessage                  ( std::string_view Message, const location<T_STATE_V> loc = location<T_STATE_V>::current())noexcept requires (std::is_enum_v<decltype(T_STATE_V)>);
 
     template <auto T_STATE_V>
-    constexpr static        void                LogMessage                  ( std::string&& Message, const std::source_location loc = std::source_location::current() )  noexcept requires (std::is_enum_v<decltype(T_STATE_V)>);
+    constexpr static        void                LogMessage                  ( std::string&& Message, const location<T_STATE_V> loc = location<T_STATE_V>::current() )  noexcept requires (std::is_enum_v<decltype(T_STATE_V)>);
 
     const char*                                 m_pMessage      = nullptr;
 
     inline static xerr_details::chain_pool      m_ChainPool     = {};
     inline static fn_error_callback*            m_pCallback     = nullptr;
+    inline static std::atomic<std::uint64_t>    m_ReportMask    = ~std::uint64_t{ 0 };    // Runtime filter of the reported states, bit (State & 63)
+    inline static std::atomic<xerr_details::fn_sink_push*> m_pSinkPush = nullptr;   // Set while the async sink runs
+    inline static xerr_details::catalog         m_Catalog       = {};
+    inline static xerr_details::state_name_registry m_StateNames = {};
+};
+
+// The unchained error must stay the size of a pointer
+static_assert(sizeof(xerr) == sizeof(const char*));
+
+//-----------------------------------------------------------------------------------------
+// XERR::RESULT
+//-----------------------------------------------------------------------------------------
+// Holds either a T or an xerr (with its usual thread chain). The xerr message pointers are
+// always odd (see info_construct), which leaves the even values free for a packed T:
+//  - Integers, enums and bools smaller than a pointer are stored shifted left by one
+//  - Pointers to types aligned to 2 or more are stored as they are
+// A packed result is a single pointer sized word. Anything else is stored next to the
+// message pointer, and when T is trivially copyable so is the result (returned in registers
+// whenever the ABI allows it for T plus a pointer).
+template< typename T >
+struct xerr::result
+{
+    static_assert(std::is_object_v<T> && !std::is_array_v<T> && !std::is_same_v<std::remove_cv_t<T>, xerr>, "xerr::result needs a value type");
+
+    constexpr static bool packed_v = []() consteval noexcept
+    {
+        if constexpr (std::is_integral_v<T> || std::is_enum_v<T>)                               return sizeof(T) < sizeof(std::uintptr_t);
+        else if constexpr (std::is_pointer_v<T> && std::is_object_v<std::remove_pointer_t<T>>)  return alignof(std::remove_pointer_t<T>) >= 2;
+        else                                                                                    return false;
+    }();
+
+    // An assignment can go from an error to a value and back, it is only a plain copy when
+    // constructing and destroying T are too
+    constexpr static bool trivial_copy_v = packed_v || (std::is_trivially_copy_assignable_v<T> && std::is_trivially_copy_constructible_v<T> && std::is_trivially_destructible_v<T>);
+    constexpr static bool trivial_move_v = packed_v || (std::is_trivially_move_assignable_v<T> && std::is_trivially_move_constructible_v<T> && std::is_trivially_destructible_v<T>);
+
+    constexpr                   result          (void)                                  noexcept requires (std::is_default_constructible_v<T>) : result(T{}) {}
+    inline                      result          (xerr Error)                            noexcept;
+    inline                      result          (const T& Value)                        noexcept requires (std::is_nothrow_copy_constructible_v<T>);
+    inline                      result          (T&& Value)                             noexcept requires (std::is_nothrow_move_constructible_v<T> && !packed_v);
+
+    constexpr                   result          (const result&)                         noexcept requires (packed_v || std::is_trivially_copy_constructible_v<T>) = default;
+    inline                      result          (const result& Other)                   noexcept requires (!packed_v && !std::is_trivially_copy_constructible_v<T>);
+    constexpr                   result          (result&&)                              noexcept requires (packed_v || std::is_trivially_move_constructible_v<T>) = default;
+    inline                      result          (result&& Other)                        noexcept requires (!packed_v && !std::is_trivially_move_constructible_v<T>);
+    constexpr   result&         operator =      (const result&)                         noexcept requires (trivial_copy_v) = default;
+    inline      result&         operator =      (const result& Other)                   noexcept requires (!trivial_copy_v);
+    constexpr   result&         operator =      (result&&)                              noexcept requires (trivial_move_v) = default;
+    inline      result&         operator =      (result&& Other)                        noexcept requires (!trivial_move_v);
+    constexpr                  ~result          (void)                                  noexcept requires (packed_v || std::is_trivially_destructible_v<T>) = default;
+    inline                     ~result          (void)                                  noexcept requires (!packed_v && !std::is_trivially_destructible_v<T>);
+
+    inline      bool            hasValue        (void)                          const   noexcept;
+    inline      explicit        operator bool   (void)                          const   noexcept { return hasValue(); }
+    inline      xerr            getError        (void)                          const   noexcept;
+
+    inline      T               getValue        (void)                          const   noexcept requires (packed_v);
+    inline      T&              getValue        (void)                          &       noexcept requires (!packed_v);
+    inline      const T&        getValue        (void)                          const&  noexcept requires (!packed_v);
+    inline      T&&             getValue        (void)                          &&      noexcept requires (!packed_v);
+    inline      T               getValueOr      (T Default)                     const   noexcept requires (std::is_nothrow_copy_constructible_v<T>);
+
+    inline static std::uintptr_t Pack           (T Value)                               noexcept requires (packed_v);
+    inline static T             Unpack          (std::uintptr_t Bits)                   noexcept requires (packed_v);
+
+    inline      decltype(auto)  operator *      (void)                          const&  noexcept { return getValue(); }
+    inline      decltype(auto)  operator *      (void)                          &       noexcept requires (!packed_v) { return getValue(); }
+    inline      decltype(auto)  operator *      (void)                          &&      noexcept requires (!packed_v) { return std::move(*this).getValue(); }
+    inline      const T*        operator ->     (void)                          const   noexcept requires (!packed_v) { return &getValue(); }
+    inline      T*              operator ->     (void)                                  noexcept requires (!packed_v) { return &getValue(); }
+
+    struct unpacked
+    {
+        constexpr               unpacked        (void)                                  noexcept {}
+        constexpr              ~unpacked        (void)                                  noexcept requires (std::is_trivially_destructible_v<T>) = default;
+        constexpr              ~unpacked        (void)                                  noexcept requires (!std::is_trivially_destructible_v<T>) {}
+
+        union { T               m_Value; };
+        const char*             m_pMessage = nullptr;   // Same as xerr::m_pMessage, nullptr when m_Value is alive
+    };
+
+    std::conditional_t< packed_v, std::uintptr_t, unpacked > m_Data;
+};
+
+//-----------------------------------------------------------------------------------------
+// STD::HASH
+//-----------------------------------------------------------------------------------------
+// Hashes the site ID, consistent with xerr::operator == (0 for no error)
+template<>
+struct std::hash<xerr>
+{
+    inline std::size_t operator()(const xerr& Error) const noexcept { return static_cast<std::size_t>(Error.getSiteID()); }
 };
 
 //-----------------------------------------------------------------------------------------
@@ -118,4 +701,19 @@ struct xerr
 //-----------------------------------------------------------------------------------------
 #include "implementation/xerr_inline.h"
 
+//-----------------------------------------------------------------------------------------
+// OPT-IN SUBSYSTEMS
+//-----------------------------------------------------------------------------------------
+// create<> reports to the ones that are compiled in, so their macro brings their header along.
+// The async sink is started at runtime, include xerr_sink.h to use it
+#if XERR_REPORT_RATE
+    #include "xerr_report_limits.h"
+#endif
+#if XERR_SITE_STATS
+    #include "xerr_site_stats.h"
+#endif
+#if XERR_FLIGHT_RECORDER
+    #include "xerr_flight_recorder.h"
+#endif
+
 #endif
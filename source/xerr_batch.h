@@ -0,0 +1,109 @@
+#ifndef XERROR_BATCH_H
+#define XERROR_BATCH_H
+#pragma once
+
+#include "xerr.h"
+
+#include <thread>
+
+//-----------------------------------------------------------------------------------------
+// XERR BATCH
+//-----------------------------------------------------------------------------------------
+// Collects the failures of a data-parallel loop without a mutex:
+//
+//      xerr::batch Batch{ Records.size() };
+//      std::for_each(std::execution::par, Records.begin(), Records.end(), [&](record& R)
+//      {
+//          Batch.Invoke(&R - Records.data(), [&] { return Process(R); });
+//      });
+//      if (Batch) Batch.ForEach([](std::size_t Index, xerr Error) { ... });
+//
+// Each failure sets its bit in a shared bitmap (one relaxed fetch_or) and goes into a list owned
+// by the thread that saw it, so threads never wait for each other. The first failure keeps its
+// cause chain (xerr::owned), the rest keep only the error so a million failures do not drain the
+// chain pool. In FIRST_ERROR mode the first failure cancels the loop: Invoke skips the elements
+// that did not start yet. Read the results once every thread of the loop is done.
+//-----------------------------------------------------------------------------------------
+namespace xerr_details
+{
+    struct batch_failure
+    {
+        std::size_t                 m_Index;
+        xerr                        m_Error;
+    };
+
+    // Failures one thread recorded, in chunks so recording never moves what was recorded
+    struct batch_collector
+    {
+        constexpr static std::size_t chunk_size_v = 62;
+
+        struct chunk
+        {
+            std::array<batch_failure, chunk_size_v> m_Failures;
+            std::uint32_t           m_Count     = 0;
+            chunk*                  m_pNext     = nullptr;
+        };
+
+        inline                     ~batch_collector (void)                                  noexcept;
+        inline      bool            Add             ( std::size_t Index, xerr Error )       noexcept;
+
+        std::thread::id             m_ThreadID  = {};
+        batch_collector*            m_pNext     = nullptr;      // Next collector of the batch
+        chunk*                      m_pChunk    = nullptr;      // Latest chunk, which is the only one not full
+        std::size_t                 m_Count     = 0;
+    };
+}
+
+//-----------------------------------------------------------------------------------------
+
+struct xerr::batch
+{
+    enum class mode : std::uint8_t
+    { ALL_ERRORS        // Every failure is recorded
+    , FIRST_ERROR       // The first failure cancels the loop, later ones only set their bit
+    };
+
+    constexpr static std::size_t    npos_v = ~std::size_t{ 0 };
+
+    inline explicit                 batch           ( std::size_t Count, mode Mode = mode::ALL_ERRORS )     noexcept;
+                                    batch           (const batch&)                                          = delete;
+    inline                         ~batch           (void)                                                  noexcept;
+                    batch&          operator =      (const batch&)                                          = delete;
+
+    // Runs Callback (returning an xerr) unless the batch was cancelled, and records its error
+    template< typename T_CALLBACK >
+    inline          bool            Invoke          ( std::size_t Index, T_CALLBACK&& Callback )            noexcept requires std::is_invocable_r_v<xerr, T_CALLBACK>;
+    inline          void            Record          ( std::size_t Index, xerr Error )                       noexcept;
+    inline          void            Cancel          (void)                                                  noexcept { m_bCancelled.store(true, std::memory_order_relaxed); }
+    inline          bool            isCancelled     (void)                                          const   noexcept { return m_bCancelled.load(std::memory_order_relaxed); }
+
+    // Results, once the loop is done
+    inline                          operator bool   (void)                                          const   noexcept { return m_FirstIndex.load(std::memory_order_acquire) != npos_v; }
+    inline          bool            isFailed        ( std::size_t Index )                           const   noexcept;
+    inline          std::size_t     getFailedCount  (void)                                          const   noexcept;
+    inline          std::size_t     getFirstIndex   (void)                                          const   noexcept { return m_FirstIndex.load(std::memory_order_acquire); }
+    inline          const owned&    getFirst        (void)                                          const   noexcept { return m_First; }
+    template< typename T_CALLBACK >
+    inline          void            ForEach         ( T_CALLBACK&& Callback )                       const   noexcept requires std::invocable<T_CALLBACK, std::size_t, xerr>;
+    inline          std::size_t     Collect         ( std::span<xerr_details::batch_failure> Out )  const   noexcept;
+    inline          void            clear           (void)                                                  noexcept;
+
+    inline          xerr_details::batch_collector* getCollector (void)                                      noexcept;
+
+    std::atomic<std::uint64_t>*                     m_pBitmap       = nullptr;  // One bit per element, nullptr if it could not be allocated
+    std::size_t                                     m_Count         = 0;
+    mode                                            m_Mode          = mode::ALL_ERRORS;
+    std::uint64_t                                   m_ID            = 0;        // Unique per batch, keys the thread cache
+    std::atomic<bool>                               m_bCancelled    = false;
+    std::atomic<std::size_t>                        m_FirstIndex    = npos_v;
+    owned                                           m_First         = {};
+    std::atomic<xerr_details::batch_collector*>     m_pCollectors   = nullptr;
+    std::atomic<std::size_t>                        m_LostCount     = 0;        // Failures only in the bitmap (out of memory)
+};
+
+//-----------------------------------------------------------------------------------------
+// IMPLEMENTATION
+//-----------------------------------------------------------------------------------------
+#include "implementation/xerr_batch_inline.h"
+
+#endif
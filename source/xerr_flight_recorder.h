@@ -0,0 +1,99 @@
+#ifndef XERROR_FLIGHT_RECORDER_H
+#define XERROR_FLIGHT_RECORDER_H
+#pragma once
+
+#include "xerr.h"
+
+//-----------------------------------------------------------------------------------------
+// XERR FLIGHT RECORDER
+//-----------------------------------------------------------------------------------------
+// Crash surviving record of the latest errors, compiled in with XERR_FLIGHT_RECORDER=1 (which
+// includes this header). build/tools has the reader:
+//
+//      xerr_details::g_FlightRecorder.Open("errors.xfr");
+//-----------------------------------------------------------------------------------------
+namespace xerr_details
+{
+    // Crash surviving log of the latest errors of every thread. Open maps a file shared with the OS, so whatever
+    // the threads wrote is in the file even when the process dies. Decode it with build/tools (xerr_flight_reader).
+    // The layout is fixed and little endian: file_header, m_MaxThreads rings of { ring_header, records } and the
+    // catalog as { catalog_header, state name, message } so the reader can name the sites without the binary.
+    // Each thread writes its own ring (no locks), a record costs a dozen stores plus a clock read.
+    struct flight_recorder
+    {
+        constexpr static std::uint32_t  magic_v     = 0x52464558;   // "XEFR"
+        constexpr static std::uint16_t  version_v   = 1;
+        constexpr static std::size_t    max_links_v = 4;
+
+        struct file_header
+        {
+            std::uint32_t               m_Magic;
+            std::uint16_t               m_Version;
+            std::uint16_t               m_RecordSize;
+            std::uint32_t               m_MaxThreads;
+            std::uint32_t               m_RecordsPerThread;
+            std::uint64_t               m_RingsOffset;
+            std::uint64_t               m_CatalogOffset;
+            std::uint64_t               m_CatalogSize;
+            std::uint64_t               m_StartTime;            // Nanoseconds since the epoch (system clock)
+            std::uint32_t               m_nThreads;             // Rings handed out (can go past m_MaxThreads)
+            std::uint32_t               m_nCatalog;             // Entries in the catalog
+            std::uint64_t               m_Reserved;
+        };
+
+        struct ring_header
+        {
+            std::uint64_t               m_ThreadID;             // Hash of the std::thread::id
+            std::uint64_t               m_Head;                 // Records ever written by the thread
+            std::uint64_t               m_Reserved[6];
+        };
+
+        struct record
+        {
+            std::uint64_t               m_SiteID;
+            std::uint64_t               m_Timestamp;            // Nanoseconds since the epoch (system clock)
+            std::uint32_t               m_Line;                 // 0 when not known (see xerr::report_policy)
+            std::uint32_t               m_Sequence;             // Index + 1 of the record, 0 while it is written
+            std::uint8_t                m_State;
+            std::uint8_t                m_nLinks;
+            std::uint8_t                m_Reserved[6];
+            std::uint64_t               m_Links[max_links_v];   // Site IDs of the previous links of the chain, the latest first
+        };
+
+        struct catalog_header
+        {
+            std::uint64_t               m_SiteID;
+            std::uint16_t               m_StateNameLength;
+            std::uint16_t               m_MessageLength;        // Full "message|hint"
+            std::uint8_t                m_State;
+            std::uint8_t                m_Reserved[3];
+        };
+
+        inline bool                     Open        ( const char* pPath, std::uint32_t MaxThreads = 64
+                                                    , std::uint32_t RecordsPerThread = 256 )        noexcept;
+        inline void                     Close       (void)                                          noexcept;
+        inline bool                     isOpen      (void)                                  const   noexcept;
+        inline void                     Write       ( const char* pMessage, std::uint32_t Line )    noexcept;
+        inline ring_header*             getRing     (void)                                          noexcept;
+
+        std::atomic<std::byte*>         m_pBase             { nullptr };
+        std::atomic<std::uint32_t>      m_Generation        { 0 };      // Bumped by each Open, threads then take a new ring
+        std::atomic<bool>               m_bOpen             { false };  // From the start of Open to the end of Close
+        std::size_t                     m_Size              = 0;
+        std::size_t                     m_RingStride        = 0;
+        std::uint32_t                   m_RecordsPerThread  = 0;
+    };
+
+    static_assert(sizeof(flight_recorder::file_header) == 64 && sizeof(flight_recorder::ring_header) == 64 && sizeof(flight_recorder::record) == 64);
+    static_assert(sizeof(flight_recorder::catalog_header) == 16);
+
+    // The recorder create<> writes to once it is open
+    inline flight_recorder g_FlightRecorder{};
+}
+
+//-----------------------------------------------------------------------------------------
+// IMPLEMENTATION
+//-----------------------------------------------------------------------------------------
+#include "implementation/xerr_flight_recorder_inline.h"
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef XERROR_FORMAT_H
+#define XERROR_FORMAT_H
+#pragma once
+
+#include "xerr.h"
+
+#if __has_include(<format>)
+    #include <format>
+#endif
+
+//-----------------------------------------------------------------------------------------
+// XERR FORMAT
+//-----------------------------------------------------------------------------------------
+// std::format support for xerr, the chain is written straight into the format output:
+//
+//      std::format_to(Out, "{}", Error);       // xerr::format_style::TEXT
+//      std::format_to(Out, "{:l}", Error);     // xerr::format_style::LINE
+//      std::format_to(Out, "{:js}", Error);    // xerr::format_style::JSON with the site IDs
+//
+// Like ForEachInChain it prints the chain of the calling thread. The spec is at most one of
+// t, l or j followed by an optional s. Without <format> (libstdc++ before 13) this header is
+// empty, Format and FormatTo still work.
+//-----------------------------------------------------------------------------------------
+#if defined(__cpp_lib_format)
+
+template<>
+struct std::formatter<xerr, char>
+{
+    constexpr auto parse(std::format_parse_context& Context)
+    {
+        auto       It  = Context.begin();
+        const auto End = Context.end();
+
+        if (It != End)
+        {
+            switch (*It)
+            {
+            case 't': m_Style = xerr::format_style::TEXT; ++It; break;
+            case 'l': m_Style = xerr::format_style::LINE; ++It; break;
+            case 'j': m_Style = xerr::format_style::JSON; ++It; break;
+            default:                                            break;
+            }
+        }
+        if (It != End && *It == 's')
+        {
+            m_bSite = true;
+            ++It;
+        }
+        if (It != End && *It != '}') throw std::format_error("xerr format spec is [t|l|j][s]");
+        return It;
+    }
+
+    template< typename T_CONTEXT >
+    auto format(const xerr& Error, T_CONTEXT& Context) const
+    {
+        return Error.FormatTo(Context.out(), m_Style, m_bSite);
+    }
+
+    xerr::format_style  m_Style = xerr::format_style::TEXT;
+    bool                m_bSite = false;
+};
+
+#endif
+#endif
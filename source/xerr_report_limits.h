@@ -0,0 +1,65 @@
+#ifndef XERROR_REPORT_LIMITS_H
+#define XERROR_REPORT_LIMITS_H
+#pragma once
+
+#include "xerr.h"
+
+//-----------------------------------------------------------------------------------------
+// XERR REPORT LIMITS
+//-----------------------------------------------------------------------------------------
+// Per-site rate limit of the reports sent to the callback or the async sink, compiled in with
+// XERR_REPORT_RATE (which includes this header). Suppressed reports are summarized later as
+// "message (N suppressed)", see limiter_registry::Flush
+//-----------------------------------------------------------------------------------------
+namespace xerr_details
+{
+    // Reports a site can send in a row before XERR_REPORT_RATE applies
+#ifndef XERR_REPORT_BURST
+    #define XERR_REPORT_BURST 16
+#endif
+
+    // Token bucket of one error site, kept as the time at which the bucket is full again (GCRA)
+    // so taking a token is a single CAS and a suppressed report a single fetch_add
+    struct site_limiter
+    {
+        constexpr static std::uint64_t  rate_v      = XERR_REPORT_RATE;
+        constexpr static std::uint64_t  burst_v     = XERR_REPORT_BURST;
+        constexpr static std::uint64_t  interval_v  = 1'000'000'000 / (rate_v ? rate_v : 1);    // Nanoseconds per token
+
+        static_assert(rate_v <= 1'000'000'000 && burst_v > 0, "XERR_REPORT_RATE/XERR_REPORT_BURST out of range");
+
+        constexpr                       site_limiter( const char* pMessage, const char* pStateName, std::uint8_t State ) noexcept
+                                        : m_pMessage{ pMessage }, m_pStateName{ pStateName }, m_State{ State } {}
+        inline bool                     Allow       (void)                                          noexcept;
+
+        std::atomic<std::uint64_t>      m_FullTime      { 0 };      // Steady clock nanoseconds
+        std::atomic<std::uint64_t>      m_Suppressed    { 0 };      // Since the last summary
+        std::atomic<bool>               m_bRegistered   { false };  // Linked into the registry
+        const char* const               m_pMessage;                 // The site, known at compile time so readers need no synchronization
+        const char* const               m_pStateName;
+        const std::uint8_t              m_State;
+        site_limiter*                   m_pNext         = nullptr;
+    };
+
+    // Lock-free list of the rate limited sites. Flush reports "message (N suppressed)" for every site
+    // that dropped reports since the last summary. The async sink calls it about once a second,
+    // without the sink call it periodically yourself
+    struct limiter_registry
+    {
+        inline void                     Register    ( site_limiter& Site )                          noexcept;
+        inline std::size_t              Flush       (void)                                          noexcept;
+        inline static void              Summarize   ( const site_limiter& Site, std::uint64_t Count ) noexcept;
+
+        std::atomic<site_limiter*>      m_pHead     { nullptr };
+    };
+
+    // Every rate limited site registers here
+    inline limiter_registry g_ReportLimits{};
+}
+
+//-----------------------------------------------------------------------------------------
+// IMPLEMENTATION
+//-----------------------------------------------------------------------------------------
+#include "implementation/xerr_report_limits_inline.h"
+
+#endif
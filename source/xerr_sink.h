@@ -0,0 +1,101 @@
+#ifndef XERROR_SINK_H
+#define XERROR_SINK_H
+#pragma once
+
+#include "xerr.h"
+
+#include <chrono>
+#include <thread>
+
+//-----------------------------------------------------------------------------------------
+// XERR ASYNC SINK
+//-----------------------------------------------------------------------------------------
+// Delivers the reports of create<> and LogMessage from a background thread instead of the
+// failing one:
+//
+//      xerr_details::g_AsyncSink.Start(OnRecord);  // void OnRecord(const xerr_details::record&)
+//      ...
+//      xerr_details::g_AsyncSink.Stop();           // Delivers what is left
+//-----------------------------------------------------------------------------------------
+namespace xerr_details
+{
+    // Records each thread can have in flight before the async sink starts dropping them (power of two)
+#ifndef XERR_SINK_RING_SIZE
+    #define XERR_SINK_RING_SIZE 256
+#endif
+
+    // Fixed size binary record of an error. It is written on the failing thread and formatted later
+    struct record
+    {
+        constexpr static std::size_t size_v = 128;
+
+        const char*     m_pMessage;                 // Message of the error (data_v), nullptr for LogMessage (see m_Text)
+        const char*     m_pStateName;               // "Enum::VALUE" from the state name table of the enum
+        const char*     m_pFile;                    // std::source_location::file_name()
+        std::uint64_t   m_Timestamp;                // Nanoseconds since the epoch (system clock)
+        std::uint32_t   m_Line;
+        std::uint8_t    m_State;
+        std::uint8_t    m_TextLength;
+        char            m_Text[sink_text_size_v];   // LogMessage text truncated to fit, or the serialized context of an error
+
+        inline std::string_view getMessage  (void)                          const noexcept;
+        inline std::string_view Format      (std::span<char> Buffer)        const noexcept;
+    };
+
+    static_assert(sizeof(record) == record::size_v);
+
+    // Single producer (the owner thread) single consumer (the drain) ring of records
+    struct sink_ring
+    {
+        constexpr static std::uint32_t size_v = XERR_SINK_RING_SIZE;
+        static_assert((size_v & (size_v - 1)) == 0, "XERR_SINK_RING_SIZE must be a power of two");
+
+        alignas(64) std::atomic<std::uint32_t>  m_Head  { 0 };          // Written by the owner thread
+        alignas(64) std::atomic<std::uint32_t>  m_Tail  { 0 };          // Written by the drain
+        std::atomic<bool>                       m_bDead { false };      // The owner thread is gone
+        sink_ring*                              m_pNext = nullptr;      // Registry link, only the drain modifies it once published
+        std::array<record, size_v>              m_Records;
+    };
+
+    // Optional asynchronous replacement for the synchronous error callback. While it runs
+    // create<> and LogMessage only write a record into a per-thread ring, and a background
+    // thread (or the user calling Drain) delivers the records. A slow consumer never blocks
+    // the producers, records are dropped (and counted) when a ring is full. Start points
+    // xerr::m_pSinkPush at xerr_details::g_AsyncSink, the one instance create<> reports to.
+    struct async_sink
+    {
+        using fn_record_callback = void(const record& Record);
+
+        inline                 ~async_sink  (void)                                                      noexcept;
+        inline void             Start       ( fn_record_callback* pCallback = nullptr
+                                            , std::chrono::milliseconds Period = std::chrono::milliseconds{ 5 } ) noexcept;
+        inline void             Stop        (void)                                                      noexcept;
+        inline bool             isRunning   (void)                                              const   noexcept;
+        inline void             Push        ( const char* pStateName, std::uint8_t State, const char* pMessage
+                                            , std::string_view Text, const char* pFile, std::uint32_t Line ) noexcept;
+        inline std::size_t      Drain       (void)                                                      noexcept;
+        inline std::size_t      DrainRings  (void)                                                      noexcept;
+        inline sink_ring*       getRing     (void)                                                      noexcept;
+        inline void             Deliver     ( const record& Record )                            const   noexcept;
+        inline static void      Fill        ( record& Record, const char* pStateName, std::uint8_t State, const char* pMessage
+                                            , std::string_view Text, const char* pFile, std::uint32_t Line ) noexcept;
+
+        std::atomic<sink_ring*>         m_pRings            { nullptr };
+        std::atomic<bool>               m_bRunning          { false };
+        std::atomic<bool>               m_bExit             { false };
+        std::atomic<std::uint64_t>      m_DropCount         { 0 };
+        fn_record_callback*             m_pRecordCallback   = nullptr;
+        std::thread                     m_Thread;
+        alignas(64) std::atomic<std::uint32_t> m_nPushing   { 0 };      // Producers inside SinkPush, Stop waits for them
+    };
+
+    // The sink create<> reports to, defined here so that only its users instantiate it (and its thread)
+    inline async_sink g_AsyncSink{};
+}
+
+//-----------------------------------------------------------------------------------------
+// IMPLEMENTATION
+//-----------------------------------------------------------------------------------------
+#include "implementation/xerr_sink_inline.h"
+
+#endif
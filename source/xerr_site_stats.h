@@ -0,0 +1,105 @@
+#ifndef XERROR_SITE_STATS_H
+#define XERROR_SITE_STATS_H
+#pragma once
+
+#include "xerr.h"
+
+#include <chrono>
+
+//-----------------------------------------------------------------------------------------
+// XERR SITE STATS
+//-----------------------------------------------------------------------------------------
+// Per-site error counters, compiled in with XERR_SITE_STATS=1 (which includes this header):
+//
+//      xerr_details::g_SiteStats.Sample();     // Periodically, for the windowed counts
+//      std::array<xerr_details::site_report, 10> Top;
+//      const auto n = xerr_details::g_SiteStats.TopN(Top, std::chrono::seconds{ 60 });
+//-----------------------------------------------------------------------------------------
+namespace xerr_details
+{
+    // Number of sites that get a counter in every thread, the sites that register after them
+    // share a single atomic counter
+#ifndef XERR_SITE_STATS_SLOTS
+    #define XERR_SITE_STATS_SLOTS 256
+#endif
+
+    // Counters of one error site. Each site registers itself the first time it fires and
+    // gets a slot in the counters of every thread, they are only added up when someone asks
+    struct site_stats
+    {
+        constexpr static std::uint32_t  slots_v   = XERR_SITE_STATS_SLOTS;
+        constexpr static std::size_t    samples_v = 16;
+        constexpr static std::uint32_t  none_v    = ~std::uint32_t{ 0 };
+
+        struct sample
+        {
+            std::uint64_t               m_Timestamp;        // Steady clock nanoseconds
+            std::uint64_t               m_Count;
+        };
+
+        inline void                     Hit         ( const char* pMessage )            noexcept;
+        inline std::uint64_t            getCount    (void)                      const   noexcept;
+
+        std::atomic<std::uint64_t>      m_Shared        { 0 };      // Sites without a slot, threads without counters
+        std::atomic<std::uint32_t>      m_iSlot         { none_v };
+        std::atomic<bool>               m_bRegistered   { false };
+        const char*                     m_pMessage      = nullptr;
+        site_stats*                     m_pNext         = nullptr;
+        std::array<sample, samples_v>   m_Samples       = {};       // History written by site_registry::Sample
+        std::uint32_t                   m_nSamples      = 0;
+    };
+
+    // One counter per site slot, written only by the thread that took the block so a hit is a
+    // plain load and store. Blocks are never freed, the block of a dead thread (counts and all)
+    // goes to the next thread that needs one
+    struct alignas(64) thread_counters
+    {
+        std::array<std::atomic<std::uint64_t>, site_stats::slots_v ? site_stats::slots_v : 1>  m_Count = {};
+        std::atomic<bool>               m_bTaken        { true };
+        thread_counters*                m_pNext         = nullptr;
+    };
+
+    // The block of the calling thread, handed back when the thread exits
+    struct thread_counters_owner
+    {
+        inline                         ~thread_counters_owner   (void)                      noexcept;
+
+        thread_counters*                m_pCounters     = nullptr;
+    };
+
+    // Result of a site_registry query
+    struct site_report
+    {
+        const char*                     m_pMessage;                 // Message of the site, xerr{ m_pMessage } gives the rest
+        std::uint64_t                   m_Count;                    // Total since the site first fired
+        std::uint64_t                   m_WindowCount;              // Within the requested window
+        double                          m_Rate;                     // Per second within the window
+    };
+
+    // Lock-free lists of every site that fired and of the thread counters. Sample and TopN
+    // are meant to be called from a single (reporting) thread
+    struct site_registry
+    {
+        inline void                     Register    ( site_stats& Site )                            noexcept;
+        inline thread_counters*         getCounters (void)                                          noexcept;
+        inline void                     Sample      (void)                                          noexcept;
+        inline std::size_t              TopN        ( std::span<site_report> Out
+                                                    , std::chrono::nanoseconds Window = {} )        noexcept;
+        template< typename T_CALLBACK >
+        inline void                     ForEach     ( T_CALLBACK&& Callback )               const   noexcept;
+
+        std::atomic<site_stats*>        m_pHead     { nullptr };
+        std::atomic<thread_counters*>   m_pCounters { nullptr };    // Every block ever allocated
+        std::atomic<std::uint32_t>      m_nSlots    { 0 };
+    };
+
+    // Every site registers here, only the users of the statistics instantiate it
+    inline site_registry g_SiteStats{};
+}
+
+//-----------------------------------------------------------------------------------------
+// IMPLEMENTATION
+//-----------------------------------------------------------------------------------------
+#include "implementation/xerr_site_stats_inline.h"
+
+#endif
@@ -0,0 +1,154 @@
+#ifndef XERROR_TASK_H
+#define XERROR_TASK_H
+#pragma once
+
+#include "xerr.h"
+
+#include <coroutine>
+#include <optional>
+
+//-----------------------------------------------------------------------------------------
+// XERR TASK
+//-----------------------------------------------------------------------------------------
+// Exception free coroutine that returns a value or an xerr:
+//
+//      xerr::task<int> ReadSize(file& File)
+//      {
+//          auto Header = co_await ReadHeader(File);    // Returns to our awaiter if ReadHeader fails
+//          if (Header.m_Size == 0) co_return xerr::create<state::INVALID, "Empty file">();
+//          co_return Header.m_Size;
+//      }
+//
+//      xerr::task<> Load(file& File)
+//      {
+//          const int Size = co_await ReadSize(File);
+//          if (Size > max_size_v) co_await xerr::create<state::INVALID, "File too big">();
+//      }
+//
+// Tasks start when they are awaited (or with Start) and continue the awaiting coroutine with
+// symmetric transfer. Errors travel as xerr::owned so the cause chain follows the coroutine to
+// whatever thread resumes it, and it is installed back on that thread when the error is read.
+//-----------------------------------------------------------------------------------------
+namespace xerr_details
+{
+    struct task_promise_base
+    {
+        struct final_awaiter
+        {
+            constexpr   bool                    await_ready     (void)                                      const   noexcept { return false; }
+            template< typename T_PROMISE >
+            inline      std::coroutine_handle<> await_suspend   (std::coroutine_handle<T_PROMISE> Handle)   const   noexcept { return Handle.promise().Complete(); }
+            constexpr   void                    await_resume    (void)                                      const   noexcept {}
+        };
+
+        // Short circuits the coroutine when an xerr or xerr::result it awaits has an error
+        template< typename T >
+        struct error_awaiter
+        {
+            inline      bool                    await_ready     (void)                                      const   noexcept;
+            inline      std::coroutine_handle<> await_suspend   (std::coroutine_handle<> Handle)                    noexcept;
+            inline      T                       await_resume    (void)                                              noexcept;
+
+            std::conditional_t< std::is_void_v<T>, xerr, xerr::result<T> >  m_Result;
+            task_promise_base*                                              m_pPromise;
+        };
+
+        constexpr   std::suspend_always         initial_suspend     (void)                                  const   noexcept { return {}; }
+        constexpr   final_awaiter               final_suspend       (void)                                  const   noexcept { return {}; }
+        inline      void                        unhandled_exception (void)                                  const   noexcept;
+        inline      std::coroutine_handle<>     Complete            (void)                                          noexcept;
+
+        inline      error_awaiter<void>         await_transform     (xerr Error)                                    noexcept;
+        template< typename T >
+        inline      error_awaiter<T>            await_transform     (xerr::result<T> Result)                        noexcept;
+        template< typename T_AWAITABLE >
+        constexpr   T_AWAITABLE&&               await_transform     (T_AWAITABLE&& Awaitable)               const   noexcept { return std::forward<T_AWAITABLE>(Awaitable); }
+
+        std::coroutine_handle<>     m_Continuation  = {};       // Coroutine awaiting this one (none for a top level task)
+        task_promise_base*          m_pParent       = nullptr;  // Promise of the awaiting task when it wants errors to short circuit it
+        xerr::owned                 m_Error         = {};
+        std::atomic<bool>           m_bDone         = false;    // Finished, either returned or short circuited
+    };
+
+    //------------------------------------------------------------------------------------
+
+    template< typename T >
+    struct task_promise : task_promise_base
+    {
+        inline      void                        return_value        (xerr::result<T> Result)                        noexcept;
+        inline      T                           TakeValue           (void)                                          noexcept { return std::move(*m_Value); }
+
+        std::optional<T>            m_Value         = {};
+    };
+
+    // A promise can not have both return_void and return_value, so a void task ends with co_return; (or by
+    // reaching its end) and fails with co_await Err; like any other error it awaits
+    template<>
+    struct task_promise<void> : task_promise_base
+    {
+        constexpr   void                        return_void         (void)                                  const   noexcept {}
+        constexpr   void                        TakeValue           (void)                                  const   noexcept {}
+    };
+}
+
+//-----------------------------------------------------------------------------------------
+
+template< typename T >
+struct xerr::task
+{
+    static_assert(std::is_void_v<T> || std::is_nothrow_move_constructible_v<T>, "xerr::task values must be nothrow movable");
+
+    using result_type = std::conditional_t< std::is_void_v<T>, xerr, xerr::result<T> >;
+
+    struct promise_type : xerr_details::task_promise<T>
+    {
+        inline      task                        get_return_object   (void)                                          noexcept { return task{ std::coroutine_handle<promise_type>::from_promise(*this) }; }
+    };
+
+    using handle = std::coroutine_handle<promise_type>;
+
+    // co_await Task: gives the value, an error short circuits the awaiting task (which must be an xerr::task)
+    struct awaiter
+    {
+        constexpr   bool                        await_ready         (void)                                  const   noexcept { return false; }
+        template< typename T_PROMISE >
+        inline      std::coroutine_handle<>     await_suspend       (std::coroutine_handle<T_PROMISE> Awaiting)     noexcept;
+        inline      T                           await_resume        (void)                                          noexcept;
+
+        handle                      m_Handle;
+    };
+
+    // co_await Task.AsResult(): gives the value or the error (with its chain on the resuming thread)
+    struct result_awaiter
+    {
+        constexpr   bool                        await_ready         (void)                                  const   noexcept { return false; }
+        inline      std::coroutine_handle<>     await_suspend       (std::coroutine_handle<> Awaiting)              noexcept;
+        inline      result_type                 await_resume        (void)                                          noexcept;
+
+        handle                      m_Handle;
+    };
+
+    constexpr                                   task                (void)                                          noexcept = default;
+    constexpr explicit                          task                (handle Handle)                                 noexcept : m_Handle{ Handle } {}
+    inline                                      task                (task&& Other)                                  noexcept : m_Handle{ std::exchange(Other.m_Handle, nullptr) } {}
+                                                task                (const task&)                                   = delete;
+    inline                                     ~task                (void)                                          noexcept { if (m_Handle) m_Handle.destroy(); }
+    inline      task&                           operator =          (task&& Other)                                  noexcept;
+                task&                           operator =          (const task&)                                   = delete;
+
+    inline      awaiter                         operator co_await   (void)                                  &&      noexcept { return { m_Handle }; }
+    inline      result_awaiter                  AsResult            (void)                                  &&      noexcept { return { m_Handle }; }
+
+    inline      void                            Start               (void)                                          noexcept;
+    inline      bool                            isDone              (void)                                  const   noexcept { return m_Handle && m_Handle.promise().m_bDone.load(std::memory_order_acquire); }
+    inline      result_type                     getResult           (void)                                          noexcept;
+
+    handle                      m_Handle    = {};
+};
+
+//-----------------------------------------------------------------------------------------
+// IMPLEMENTATION
+//-----------------------------------------------------------------------------------------
+#include "implementation/xerr_task_inline.h"
+
+#endif